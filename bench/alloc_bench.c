@@ -0,0 +1,298 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* malloc, exit     */
+#include <unistd.h>         /* fork, sysconf    */
+#include <sys/wait.h>       /* waitpid          */
+
+#include "scheduler.h"
+#include "priority_q.h"
+#include "arena.h"
+
+#define TASKS (10000)
+#define RUNS (1000000)
+#define CHURN (1000000)
+#define RSS_TASKS (1000000)
+#define MAX_INTERVAL (3600000)
+
+/* linked with --wrap, every allocation of the process goes through here */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t count, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+
+static size_t g_allocs = 0;
+static size_t g_runs = 0;
+static sch_t *g_sch = NULL;
+
+static void RunTicks(const char *name, int use_wheel);
+static void RunChurn(const char *name, int use_wheel);
+static void RunQueue(const char *name, int use_arena);
+static void RunRss(const char *name, int kind);
+static int Tick(void *arg);
+static int Noop(void *arg);
+static int IsBefore(const void *data, const void *to_compare);
+static size_t Rand(void);
+static size_t RssBytes(void);
+
+int main(void)
+{
+    printf("allocations per operation, after warm up\n");
+    printf("%-28s %14s\n", "case", "allocs/op");
+
+    RunTicks("heap tick", 0);
+    RunTicks("wheel tick", 1);
+    RunChurn("heap SchAdd+SchRemove", 0);
+    RunChurn("wheel SchAdd+SchRemove", 1);
+    RunQueue("list pq malloc", 0);
+    RunQueue("list pq arena", 1);
+
+    printf("\nresident memory per million elements\n");
+    printf("%-28s %14s\n", "case", "MiB/M");
+
+    RunRss("heap tasks", 0);
+    RunRss("wheel tasks", 1);
+    RunRss("list pq nodes malloc", 2);
+    RunRss("list pq nodes arena", 3);
+
+    return 0;
+}
+
+void *__wrap_malloc(size_t size)
+{
+    ++g_allocs;
+
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    ++g_allocs;
+
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    ++g_allocs;
+
+    return __real_realloc(ptr, size);
+}
+
+/* one tick is one task run, popped from the queue and pushed back */
+static void RunTicks(const char *name, int use_wheel)
+{
+    size_t allocs = 0;
+    size_t i = 0;
+
+    g_sch = use_wheel ? SchCreateWheel() : SchCreate();
+
+    if (NULL == g_sch)
+    {
+        return;
+    }
+
+    for (i = 0; i < TASKS; ++i)
+    {
+        SchAdd(g_sch, 0, Tick, NULL);
+    }
+
+    g_runs = 0;
+    allocs = g_allocs;
+    SchRun(g_sch);
+
+    printf("%-28s %14.6f\n", name, (double)(g_allocs - allocs) / g_runs);
+
+    SchDestroy(g_sch);
+}
+
+static void RunChurn(const char *name, int use_wheel)
+{
+    sch_t *sch = use_wheel ? SchCreateWheel() : SchCreate();
+    size_t allocs = 0;
+    size_t i = 0;
+
+    if (NULL == sch)
+    {
+        return;
+    }
+
+    /* warm up the pool and the tables */
+    for (i = 0; i < TASKS; ++i)
+    {
+        SchRemove(sch, SchAdd(sch, 1 + Rand() % MAX_INTERVAL, Noop, NULL));
+    }
+
+    allocs = g_allocs;
+
+    for (i = 0; i < CHURN; ++i)
+    {
+        SchRemove(sch, SchAdd(sch, 1 + Rand() % MAX_INTERVAL, Noop, NULL));
+    }
+
+    printf("%-28s %14.6f\n", name, (double)(g_allocs - allocs) / CHURN);
+
+    SchDestroy(sch);
+}
+
+static void RunQueue(const char *name, int use_arena)
+{
+    static size_t keys[TASKS];
+    arena_t *arena = ArenaCreate(0);
+    pq_t *pq = NULL;
+    size_t allocs = 0;
+    size_t i = 0;
+
+    if (NULL == arena)
+    {
+        return;
+    }
+
+    pq = use_arena ? PriorityQCreateFromArena(IsBefore, arena) :
+                                                PriorityQCreate(IsBefore);
+
+    for (i = 0; i < TASKS / 10; ++i)
+    {
+        keys[i] = Rand() % MAX_INTERVAL;
+        PriorityQEnqueue(pq, &keys[i]);
+    }
+
+    allocs = g_allocs;
+
+    for (i = 0; i < CHURN / 10; ++i)
+    {
+        size_t *key = (size_t *)PriorityQPeek(pq);
+
+        PriorityQDequeue(pq);
+        *key += Rand() % MAX_INTERVAL;
+        PriorityQEnqueue(pq, key);
+    }
+
+    printf("%-28s %14.6f\n", name, (double)(g_allocs - allocs) / (CHURN / 10));
+
+    PriorityQDestroy(pq);
+    ArenaDestroy(arena);
+}
+
+/* one child per run, so RSS is not polluted by earlier runs */
+static void RunRss(const char *name, int kind)
+{
+    pid_t child = 0;
+
+    fflush(stdout);
+    child = fork();
+
+    if (0 == child)
+    {
+        size_t *keys = (size_t *)malloc(RSS_TASKS * sizeof(size_t));
+        arena_t *arena = ArenaCreate(0);
+        size_t rss = 0;
+        sch_t *sch = NULL;
+        pq_t *pq = NULL;
+        size_t i = 0;
+
+        if (NULL == keys || NULL == arena)
+        {
+            exit(1);
+        }
+
+        /* keys are touched before the baseline, only nodes count */
+        for (i = 0; i < RSS_TASKS; ++i)
+        {
+            keys[i] = i;
+        }
+
+        rss = RssBytes();
+
+        if (kind < 2)
+        {
+            sch = (1 == kind) ? SchCreateWheel() : SchCreate();
+        }
+        else
+        {
+            pq = (3 == kind) ? PriorityQCreateFromArena(IsBefore, arena) :
+                                                PriorityQCreate(IsBefore);
+        }
+
+        for (i = 0; i < RSS_TASKS; ++i)
+        {
+            if (NULL != sch)
+            {
+                SchAdd(sch, 1 + Rand() % MAX_INTERVAL, Noop, NULL);
+            }
+            else
+            {
+                /* each key lands at the front, the list walk stays short */
+                PriorityQEnqueue(pq, &keys[i]);
+            }
+        }
+
+        printf("%-28s %14.1f\n", name,
+                        (double)(RssBytes() - rss) / (1024 * 1024));
+        fflush(stdout);
+
+        exit(0);
+    }
+
+    waitpid(child, NULL, 0);
+}
+
+static int Tick(void *arg)
+{
+    (void)arg;
+
+    if (++g_runs >= RUNS)
+    {
+        SchStop(g_sch);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+static int Noop(void *arg)
+{
+    (void)arg;
+
+    return 0;
+}
+
+static int IsBefore(const void *data, const void *to_compare)
+{
+    return ((*(const size_t *)data < *(const size_t *)to_compare) ? 0 : 1);
+}
+
+static size_t Rand(void)
+{
+    static unsigned long state = 88172645463325252UL;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return (size_t)state;
+}
+
+static size_t RssBytes(void)
+{
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+
+    if (NULL == statm)
+    {
+        return 0;
+    }
+
+    if (2 != fscanf(statm, "%lu %lu", &size, &resident))
+    {
+        resident = 0;
+    }
+
+    fclose(statm);
+
+    return resident * sysconf(_SC_PAGESIZE);
+}
@@ -0,0 +1,210 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* malloc           */
+#include <time.h>           /* clock_gettime    */
+
+#include "dllist.h"
+
+#define MIN_SIZE (10000)
+#define MAX_SIZE (10000000)
+#define WALK_STEPS (100000000)
+#define INSERT_EVERY (4)
+#define NODE_BYTES (24)
+#define BLOCK_BYTES (128)
+
+typedef struct
+{
+    double build;
+    double walk;
+    double insert;
+} result_t;
+
+static void **g_chunks = NULL;
+
+static void Run(size_t size);
+static void Measure(int unrolled, size_t size, int aged, result_t *result);
+static void Scatter(size_t count, size_t bytes, int aligned);
+static int SumOp(void *data, void *arg);
+static size_t Rand(size_t *seed);
+static long NowNs(void);
+
+int main(void)
+{
+    size_t size = 0;
+
+    /*
+        kept for the whole run, freeing a large array would merge the
+        scattered chunks back
+    */
+    g_chunks = (void **)malloc(MAX_SIZE * sizeof(void *));
+
+    if (NULL == g_chunks)
+    {
+        return 1;
+    }
+
+    printf("node list vs unrolled list, ns per element. aged: the heap "
+                            "hands out memory in random order, as after churn\n");
+    printf("%10s %8s %10s %10s %10s %10s %10s %10s\n", "size", "",
+                    "build", "", "walk", "", "insert", "");
+    printf("%10s %8s %10s %10s %10s %10s %10s %10s\n", "", "",
+        "nodes", "unrolled", "nodes", "unrolled", "nodes", "unrolled");
+
+    for (size = MIN_SIZE; size <= MAX_SIZE; size *= 10)
+    {
+        Run(size);
+    }
+
+    free(g_chunks);
+
+    return 0;
+}
+
+static void Run(size_t size)
+{
+    result_t nodes = {0};
+    result_t blocks = {0};
+    int aged = 0;
+
+    for (aged = 0; aged <= 1; ++aged)
+    {
+        Measure(0, size, aged, &nodes);
+        Measure(1, size, aged, &blocks);
+
+        printf("%10lu %8s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+            (unsigned long)size, aged ? "aged" : "fresh", nodes.build,
+            blocks.build, nodes.walk, blocks.walk, nodes.insert,
+            blocks.insert);
+    }
+}
+
+/*
+    build pushes size elements to the back, walk is DLForEach over
+    them, insert walks once and adds an element after every
+    INSERT_EVERY'th, at the iterator the walk is on.
+*/
+static void Measure(int unrolled, size_t size, int aged, result_t *result)
+{
+    dlist_t *list = NULL;
+    size_t walks = (WALK_STEPS / size) ? WALK_STEPS / size : 1;
+    size_t sum = 0;
+    size_t added = 0;
+    diter_t iter;
+    long start = 0;
+    size_t i = 0;
+
+    if (aged)
+    {
+        Scatter(size, unrolled ? BLOCK_BYTES : NODE_BYTES, unrolled);
+    }
+
+    list = unrolled ? DLCreateUnrolled() : DLCreate();
+
+    if (NULL == list)
+    {
+        return;
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < size; ++i)
+    {
+        DLPushBack(list, (void *)(i + 1));
+    }
+
+    result->build = (double)(NowNs() - start) / size;
+    start = NowNs();
+
+    for (i = 0; i < walks; ++i)
+    {
+        DLForEach(DLBegin(list), DLEnd(list), SumOp, &sum);
+    }
+
+    result->walk = (double)(NowNs() - start) / walks / size;
+
+    /* keeps the walk from being optimized away */
+    if (sum != walks * (size * (size + 1) / 2))
+    {
+        printf("bad sum\n");
+    }
+
+    start = NowNs();
+
+    for (iter = DLBegin(list), i = 0; !DLIsSameIter(iter, DLEnd(list)); ++i)
+    {
+        if (0 == i % INSERT_EVERY)
+        {
+            iter = DLInsertAfter(list, iter, (void *)i);
+            ++added;
+        }
+
+        iter = DLNext(iter);
+    }
+
+    result->insert = (double)(NowNs() - start) / added;
+
+    DLDestroy(list);
+}
+
+/* allocate and free in random order, so the next allocations scatter */
+static void Scatter(size_t count, size_t bytes, int aligned)
+{
+    void **chunks = g_chunks;
+    size_t seed = 12345;
+    size_t i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        chunks[i] = NULL;
+
+        if (aligned)
+        {
+            if (0 != posix_memalign(&chunks[i], bytes, bytes))
+            {
+                chunks[i] = NULL;
+            }
+        }
+        else
+        {
+            chunks[i] = malloc(bytes);
+        }
+    }
+
+    for (i = count - 1; 0 < i; --i)
+    {
+        size_t j = Rand(&seed) % (i + 1);
+        void *tmp = chunks[i];
+
+        chunks[i] = chunks[j];
+        chunks[j] = tmp;
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        free(chunks[i]);
+    }
+}
+
+static int SumOp(void *data, void *arg)
+{
+    *(size_t *)arg += (size_t)data;
+
+    return 0;
+}
+
+static size_t Rand(size_t *seed)
+{
+    *seed = *seed * 6364136223846793005UL + 1442695040888963407UL;
+
+    return *seed >> 33;
+}
+
+static long NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
@@ -0,0 +1,163 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* malloc           */
+#include <time.h>           /* clock_gettime    */
+
+#include "scheduler.h"
+#include "priority_q.h"
+
+#define TASKS (1000000)
+#define CANCEL_PERCENT (90)
+#define MAX_INTERVAL (3600000)
+#define ERASE_SAMPLES (50)
+
+typedef struct
+{
+    size_t key;
+} item_t;
+
+static void RunSch(const char *name, int use_wheel);
+static void RunErase(void);
+static int Noop(void *arg);
+static int IsBefore(const void *data, const void *to_compare);
+static int IsSame(const void *data, void *arg);
+static double NowNs(void);
+static size_t Rand(void);
+
+int main(void)
+{
+    printf("arm %d timeouts, cancel %d%% of them in random order\n", TASKS,
+                                                            CANCEL_PERCENT);
+    printf("%-10s %12s %14s %12s\n", "engine", "add ns/op", "cancel ns/op",
+                                                                "left");
+
+    RunSch("heap", 0);
+    RunSch("wheel", 1);
+    RunErase();
+
+    return 0;
+}
+
+static void RunSch(const char *name, int use_wheel)
+{
+    sch_t *sch = use_wheel ? SchCreateWheel() : SchCreate();
+    ilrd_uid_t *uids = (ilrd_uid_t *)malloc(TASKS * sizeof(ilrd_uid_t));
+    size_t cancels = TASKS / 100 * CANCEL_PERCENT;
+    double start = 0;
+    double add = 0;
+    double cancel = 0;
+    size_t i = 0;
+
+    if (NULL == sch || NULL == uids)
+    {
+        return;
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < TASKS; ++i)
+    {
+        uids[i] = SchAdd(sch, 1 + Rand() % MAX_INTERVAL, Noop, NULL);
+    }
+
+    add = NowNs() - start;
+
+    /* shuffle, so cancels do not follow the heap layout */
+    for (i = TASKS - 1; 0 < i; --i)
+    {
+        size_t j = Rand() % (i + 1);
+        ilrd_uid_t tmp = uids[i];
+
+        uids[i] = uids[j];
+        uids[j] = tmp;
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < cancels; ++i)
+    {
+        SchRemove(sch, uids[i]);
+    }
+
+    cancel = NowNs() - start;
+
+    printf("%-10s %12.1f %14.1f %12lu\n", name, add / TASKS,
+                            cancel / cancels, (unsigned long)SchSize(sch));
+
+    SchDestroy(sch);
+    free(uids);
+}
+
+/* the search SchRemove did before, sampled, a full run takes hours */
+static void RunErase(void)
+{
+    item_t *items = (item_t *)malloc(TASKS * sizeof(item_t));
+    pq_t *pq = PriorityQCreateHeap(IsBefore, 0);
+    double start = 0;
+    size_t i = 0;
+
+    if (NULL == items || NULL == pq)
+    {
+        return;
+    }
+
+    for (i = 0; i < TASKS; ++i)
+    {
+        items[i].key = Rand() % MAX_INTERVAL;
+        PriorityQEnqueue(pq, &items[i]);
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < ERASE_SAMPLES; ++i)
+    {
+        PriorityQErase(pq, IsSame, &items[Rand() % TASKS]);
+    }
+
+    printf("%-10s %12s %14.1f %12s\n", "erase scan", "-",
+                            (NowNs() - start) / ERASE_SAMPLES, "-");
+
+    PriorityQDestroy(pq);
+    free(items);
+}
+
+static int Noop(void *arg)
+{
+    (void)arg;
+
+    return 0;
+}
+
+static int IsBefore(const void *data, const void *to_compare)
+{
+    const item_t *item = data;
+    const item_t *item_to_compare = to_compare;
+
+    return ((item->key < item_to_compare->key) ? 0 : 1);
+}
+
+static int IsSame(const void *data, void *arg)
+{
+    return (data == arg);
+}
+
+static double NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+static size_t Rand(void)
+{
+    static unsigned long state = 88172645463325252UL;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return (size_t)state;
+}
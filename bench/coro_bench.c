@@ -0,0 +1,148 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* exit             */
+#include <time.h>           /* clock_gettime    */
+#include <unistd.h>         /* fork, sysconf    */
+#include <sys/wait.h>       /* waitpid          */
+
+#include "scheduler.h"
+
+#define MIN_CHECKS (1000)
+#define MAX_CHECKS (20000)
+#define STACK_SIZE (16384)
+#define PROBE_WAIT_MS (20)
+#define STEPS (4)
+
+static sch_t *g_sch = NULL;
+static size_t g_finished = 0;
+static size_t g_rss_peak = 0;
+static size_t g_switches = 0;
+
+static int HealthCheck(void *arg);
+static double NowNs(void);
+static size_t RssBytes(void);
+static void Run(const char *name, int use_wheel, size_t checks);
+
+int main(void)
+{
+    size_t n = 0;
+
+    printf("health checks as coroutines: %d x (probe, sleep %d ms, act, "
+                            "yield), %d KiB stacks\n", STEPS, PROBE_WAIT_MS,
+                                                        STACK_SIZE / 1024);
+    printf("%-8s %10s %14s %14s %16s\n", "engine", "in flight",
+                    "ns/switch", "wall ms", "RSS KiB/check");
+
+    for (n = MIN_CHECKS; n <= MAX_CHECKS; n *= 2)
+    {
+        Run("heap", 0, n);
+        Run("wheel", 1, n);
+    }
+
+    return 0;
+}
+
+/* one child per run, so RSS is not polluted by earlier runs */
+static void Run(const char *name, int use_wheel, size_t checks)
+{
+    pid_t child = 0;
+
+    fflush(stdout);
+    child = fork();
+
+    if (0 == child)
+    {
+        sch_attr_t attr = {0};
+        size_t rss = RssBytes();
+        double start = 0;
+        double wall = 0;
+        size_t i = 0;
+
+        g_sch = use_wheel ? SchCreateWheel() : SchCreate();
+
+        if (NULL == g_sch)
+        {
+            exit(1);
+        }
+
+        SchAttrInit(&attr, 0);
+        attr.stack_size = STACK_SIZE;
+
+        for (i = 0; i < checks; ++i)
+        {
+            SchAddAttr(g_sch, &attr, HealthCheck, (void *)i);
+        }
+
+        start = NowNs();
+        SchRun(g_sch);
+        wall = NowNs() - start;
+
+        /* every sleep is idle time, a switch is a suspend plus a resume */
+        printf("%-8s %10lu %14.1f %14.1f %16.1f\n", name,
+                (unsigned long)checks,
+                (wall - STEPS * PROBE_WAIT_MS * 1e6) / g_switches,
+                wall / 1e6, (double)(g_rss_peak - rss) / 1024 / checks);
+        fflush(stdout);
+
+        SchDestroy(g_sch);
+        exit(0);
+    }
+
+    waitpid(child, NULL, 0);
+}
+
+static int HealthCheck(void *arg)
+{
+    size_t step = 0;
+    volatile size_t probe = (size_t)arg;
+
+    for (step = 0; step < STEPS; ++step)
+    {
+        probe = probe * 31 + step;
+        SchSleepFor(g_sch, PROBE_WAIT_MS);
+        probe ^= step;
+        SchYield(g_sch);
+        g_switches += 4;
+    }
+
+    /* all start in the first pass, the first to finish sees them all */
+    if (0 == g_finished)
+    {
+        g_rss_peak = RssBytes();
+    }
+
+    ++g_finished;
+
+    return 1;
+}
+
+static double NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+static size_t RssBytes(void)
+{
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+
+    if (NULL == statm)
+    {
+        return 0;
+    }
+
+    if (2 != fscanf(statm, "%lu %lu", &size, &resident))
+    {
+        resident = 0;
+    }
+
+    fclose(statm);
+
+    return resident * sysconf(_SC_PAGESIZE);
+}
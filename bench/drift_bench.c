@@ -0,0 +1,137 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <time.h>           /* clock_gettime    */
+
+#include "scheduler.h"
+
+#define INTERVAL_MS (10)
+#define RUNS (300)
+#define STALL_EVERY (50)
+#define STALL_MS (35)
+#define NS_IN_MS (1000000L)
+
+typedef struct
+{
+    long first_ns;
+    long last_ns;
+    long max_late_ns;
+    size_t runs;
+    size_t missed_seen;
+    int stall;
+    ilrd_uid_t uid;
+    sch_t *sch;
+} ctx_t;
+
+static int Beat(void *arg);
+static long NowNs(void);
+static void Spin(long ns);
+static void Run(const char *name, int use_wheel, sch_overrun_t overrun,
+                                                                int stall);
+
+int main(void)
+{
+    printf("heartbeat every %d ms, %d runs (phase = last start minus its "
+                                        "grid tick, us)\n", INTERVAL_MS, RUNS);
+    printf("%-8s %-9s %-14s %8s %10s %10s %12s\n", "engine", "policy",
+                    "load", "missed", "phase", "max late", "elapsed ms");
+
+    Run("heap", 0, SCH_CATCH_UP, 0);
+    Run("heap", 0, SCH_CATCH_UP, 1);
+    Run("heap", 0, SCH_SKIP, 1);
+    Run("heap", 0, SCH_BURST, 1);
+    Run("wheel", 1, SCH_CATCH_UP, 0);
+    Run("wheel", 1, SCH_CATCH_UP, 1);
+    Run("wheel", 1, SCH_SKIP, 1);
+    Run("wheel", 1, SCH_BURST, 1);
+
+    return 0;
+}
+
+/* every run works 1 ms, with stall one in STALL_EVERY runs STALL_MS */
+static void Run(const char *name, int use_wheel, sch_overrun_t overrun,
+                                                                int stall)
+{
+    static const char *policies[] = {"catch-up", "skip", "burst"};
+    sch_t *sch = use_wheel ? SchCreateWheel() : SchCreate();
+    sch_attr_t attr = {0};
+    ctx_t ctx = {0};
+    long grid = INTERVAL_MS * NS_IN_MS;
+    long phase = 0;
+
+    if (NULL == sch)
+    {
+        return;
+    }
+
+    SchAttrInit(&attr, INTERVAL_MS);
+    attr.overrun = overrun;
+    ctx.sch = sch;
+    ctx.stall = stall;
+    ctx.first_ns = NowNs() + grid;
+    ctx.uid = SchAddAttr(sch, &attr, Beat, &ctx);
+    SchRun(sch);
+
+    /* phase drifts by run time on every tick without anchoring */
+    phase = (ctx.last_ns - ctx.first_ns) % grid;
+    phase = (phase > grid / 2) ? phase - grid : phase;
+
+    printf("%-8s %-9s %-14s %8lu %10.1f %10.1f %12.1f\n", name,
+                policies[overrun], stall ? "1 ms + stalls" : "1 ms",
+                (unsigned long)ctx.missed_seen,
+                phase / 1e3, ctx.max_late_ns / 1e3,
+                (ctx.last_ns - ctx.first_ns) / 1e6);
+
+    SchDestroy(sch);
+}
+
+static int Beat(void *arg)
+{
+    ctx_t *ctx = (ctx_t *)arg;
+    long now = NowNs();
+    long grid = INTERVAL_MS * NS_IN_MS;
+    long late = (now - ctx->first_ns) % grid;
+
+    ctx->last_ns = now;
+    ++ctx->runs;
+    ctx->missed_seen = SchMissedTicks(ctx->sch, ctx->uid);
+
+    if (late < grid / 2 && late > ctx->max_late_ns)
+    {
+        ctx->max_late_ns = late;
+    }
+
+    if (RUNS <= ctx->runs)
+    {
+        return 1;
+    }
+
+    if (ctx->stall && 0 == ctx->runs % STALL_EVERY)
+    {
+        Spin(STALL_MS * NS_IN_MS);
+    }
+    else
+    {
+        Spin(NS_IN_MS);
+    }
+
+    return 0;
+}
+
+static void Spin(long ns)
+{
+    long end = NowNs() + ns;
+
+    while (NowNs() < end)
+    {
+    }
+}
+
+static long NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
@@ -0,0 +1,129 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* malloc, qsort    */
+#include <time.h>           /* clock_gettime    */
+
+#include "scheduler.h"
+
+#define MAX_TASKS (1024)
+#define INTERVAL_MS (5)
+#define RUN_NS (1000000000L)
+#define MAX_SAMPLES (4000000)
+
+typedef struct
+{
+    long next_ns;
+} ctx_t;
+
+static long g_end_ns = 0;
+static long *g_samples = NULL;
+static size_t g_count = 0;
+
+static int Sample(void *arg);
+static int CmpLong(const void *a, const void *b);
+static long NowNs(void);
+static void Run(const char *name, int use_wheel, size_t tasks);
+
+int main(void)
+{
+    size_t tasks = 0;
+
+    g_samples = (long *)malloc(MAX_SAMPLES * sizeof(long));
+
+    if (NULL == g_samples)
+    {
+        return 1;
+    }
+
+    printf("start minus deadline, interval %d ms, %.1f s per run (us)\n",
+                                    INTERVAL_MS, (double)RUN_NS / 1e9);
+    printf("%-8s %8s %10s %10s %10s %10s %10s\n", "engine", "tasks",
+                                "samples", "p50", "p99", "p999", "max");
+
+    for (tasks = 1; tasks <= MAX_TASKS; tasks *= 32)
+    {
+        Run("heap", 0, tasks);
+        Run("wheel", 1, tasks);
+    }
+
+    free(g_samples);
+
+    return 0;
+}
+
+static void Run(const char *name, int use_wheel, size_t tasks)
+{
+    sch_t *sch = use_wheel ? SchCreateWheel() : SchCreate();
+    ctx_t *ctx = (ctx_t *)malloc(tasks * sizeof(ctx_t));
+    size_t i = 0;
+
+    if (NULL == sch || NULL == ctx)
+    {
+        return;
+    }
+
+    g_count = 0;
+    g_end_ns = NowNs() + RUN_NS;
+
+    for (i = 0; i < tasks; ++i)
+    {
+        ctx[i].next_ns = NowNs() + INTERVAL_MS * 1000000L;
+        SchAdd(sch, INTERVAL_MS, Sample, &ctx[i]);
+    }
+
+    SchRun(sch);
+
+    qsort(g_samples, g_count, sizeof(long), CmpLong);
+
+    if (0 < g_count)
+    {
+        printf("%-8s %8lu %10lu %10.1f %10.1f %10.1f %10.1f\n", name,
+            (unsigned long)tasks, (unsigned long)g_count,
+            g_samples[g_count / 2] / 1e3,
+            g_samples[g_count * 99 / 100] / 1e3,
+            g_samples[g_count * 999 / 1000] / 1e3,
+            g_samples[g_count - 1] / 1e3);
+    }
+
+    SchDestroy(sch);
+    free(ctx);
+}
+
+/* deadlines are anchored, the next one is an interval after this one */
+static int Sample(void *arg)
+{
+    ctx_t *ctx = (ctx_t *)arg;
+    long now = NowNs();
+
+    if (g_count < MAX_SAMPLES)
+    {
+        g_samples[g_count++] = now - ctx->next_ns;
+    }
+
+    if (now >= g_end_ns)
+    {
+        return 1;
+    }
+
+    ctx->next_ns += INTERVAL_MS * 1000000L;
+
+    return 0;
+}
+
+static int CmpLong(const void *a, const void *b)
+{
+    long left = *(const long *)a;
+    long right = *(const long *)b;
+
+    return (left > right) - (left < right);
+}
+
+static long NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
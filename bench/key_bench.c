@@ -0,0 +1,235 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* malloc           */
+#include <time.h>           /* clock_gettime    */
+
+#include "priority_q.h"
+#include "sorted_ll.h"
+
+#define MIN_SIZE (1000)
+#define MAX_SIZE (1000000)
+#define OPS (1000000)
+#define MAX_INTERVAL_NS (1000000000UL)
+
+/* the part of the scheduler's task the old comparator reads */
+typedef struct
+{
+    struct timespec time_to_run;
+    size_t runs;
+} task_t;
+
+typedef enum
+{
+    HEAP,
+    SKIP
+} engine_t;
+
+static void Run(size_t size);
+static double Measure(engine_t engine, int keyed, task_t **tasks,
+                                                            size_t size);
+static void Push(pq_t *pq, sortedlist_t *list, int keyed, task_t *task);
+static int IsPrior(const void *data, const void *to_compare);
+static int IsBefore(const void *data, const void *to_compare);
+static int TimeIsBefore(const struct timespec *time1,
+                                        const struct timespec *time2);
+static void Advance(task_t *task, size_t *seed);
+static size_t TimeToNs(const struct timespec *time);
+static long NowNs(void);
+
+int main(void)
+{
+    size_t size = 0;
+
+    printf("scheduler hold model: pop the earliest task, push it back "
+                                        "later, ns per pop + push\n");
+    printf("%10s %12s %12s %8s %12s %12s %8s\n", "tasks", "heap cmp",
+            "heap keyed", "speedup", "skip cmp", "skip keyed", "speedup");
+
+    for (size = MIN_SIZE; size <= MAX_SIZE; size *= 10)
+    {
+        Run(size);
+    }
+
+    return 0;
+}
+
+static void Run(size_t size)
+{
+    task_t **tasks = (task_t **)malloc(size * sizeof(task_t *));
+    double ns[2][2] = {{0}};
+    size_t i = 0;
+
+    if (NULL == tasks)
+    {
+        return;
+    }
+
+    /* one allocation per task, as the scheduler's are */
+    for (i = 0; i < size; ++i)
+    {
+        tasks[i] = (task_t *)malloc(sizeof(task_t));
+
+        if (NULL == tasks[i])
+        {
+            size = i;
+            break;
+        }
+    }
+
+    ns[HEAP][0] = Measure(HEAP, 0, tasks, size);
+    ns[HEAP][1] = Measure(HEAP, 1, tasks, size);
+    ns[SKIP][0] = Measure(SKIP, 0, tasks, size);
+    ns[SKIP][1] = Measure(SKIP, 1, tasks, size);
+
+    printf("%10lu %12.1f %12.1f %7.2fx %12.1f %12.1f %7.2fx\n",
+        (unsigned long)size, ns[HEAP][0], ns[HEAP][1],
+        ns[HEAP][0] / ns[HEAP][1], ns[SKIP][0], ns[SKIP][1],
+        ns[SKIP][0] / ns[SKIP][1]);
+
+    for (i = 0; i < size; ++i)
+    {
+        free(tasks[i]);
+    }
+
+    free(tasks);
+}
+
+/* every variant sees the same deadlines */
+static double Measure(engine_t engine, int keyed, task_t **tasks,
+                                                            size_t size)
+{
+    pq_t *pq = NULL;
+    sortedlist_t *list = NULL;
+    size_t seed = 12345;
+    long start = 0;
+    size_t i = 0;
+
+    if (HEAP == engine)
+    {
+        pq = keyed ? PriorityQCreateKeyed(0, NULL) :
+                                        PriorityQCreateHeap(IsPrior, 0);
+    }
+    else
+    {
+        list = keyed ? SortedListCreateKeyed() : SortedListCreateSkip(IsBefore);
+    }
+
+    if (NULL == pq && NULL == list)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < size; ++i)
+    {
+        tasks[i]->time_to_run.tv_sec = 0;
+        tasks[i]->time_to_run.tv_nsec = 0;
+        Advance(tasks[i], &seed);
+
+        Push(pq, list, keyed, tasks[i]);
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < OPS; ++i)
+    {
+        task_t *task = NULL;
+
+        if (NULL != pq)
+        {
+            task = (task_t *)PriorityQPeek(pq);
+            PriorityQDequeue(pq);
+        }
+        else
+        {
+            task = (task_t *)SortedListPopFront(list);
+        }
+
+        ++task->runs;
+        Advance(task, &seed);
+
+        Push(pq, list, keyed, task);
+    }
+
+    start = NowNs() - start;
+
+    if (NULL != pq)
+    {
+        PriorityQDestroy(pq);
+    }
+    else
+    {
+        SortedListDestroy(list);
+    }
+
+    return (double)start / OPS;
+}
+
+static void Push(pq_t *pq, sortedlist_t *list, int keyed, task_t *task)
+{
+    size_t key = TimeToNs(&task->time_to_run);
+
+    if (NULL != pq && keyed)
+    {
+        PriorityQEnqueueKeyed(pq, task, key);
+    }
+    else if (NULL != pq)
+    {
+        PriorityQEnqueue(pq, task);
+    }
+    else if (keyed)
+    {
+        SortedListInsertKeyed(list, task, key);
+    }
+    else
+    {
+        SortedListInsert(list, task);
+    }
+}
+
+/* the scheduler's comparator before the keyed queue */
+static int IsPrior(const void *data, const void *to_compare)
+{
+    const task_t *task_data = data;
+    const task_t *task_to_compare = to_compare;
+
+    return (TimeIsBefore(&task_data->time_to_run,
+                                &task_to_compare->time_to_run) ? 0 : 1);
+}
+
+static int IsBefore(const void *data, const void *to_compare)
+{
+    return TimeIsBefore(&((const task_t *)data)->time_to_run,
+                                &((const task_t *)to_compare)->time_to_run);
+}
+
+static int TimeIsBefore(const struct timespec *time1,
+                                        const struct timespec *time2)
+{
+    return (time1->tv_sec < time2->tv_sec || (time1->tv_sec == time2->tv_sec
+                                    && time1->tv_nsec < time2->tv_nsec));
+}
+
+static void Advance(task_t *task, size_t *seed)
+{
+    size_t ns = 0;
+
+    *seed = *seed * 6364136223846793005UL + 1442695040888963407UL;
+    ns = TimeToNs(&task->time_to_run) + 1 + (*seed >> 33) % MAX_INTERVAL_NS;
+    task->time_to_run.tv_sec = (time_t)(ns / 1000000000UL);
+    task->time_to_run.tv_nsec = (long)(ns % 1000000000UL);
+}
+
+static size_t TimeToNs(const struct timespec *time)
+{
+    return (size_t)time->tv_sec * 1000000000UL + (size_t)time->tv_nsec;
+}
+
+static long NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
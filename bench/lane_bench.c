@@ -0,0 +1,150 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <time.h>           /* clock_gettime    */
+
+#include "scheduler.h"
+
+#define CRITICAL (8)
+#define CRITICAL_MS (5)
+#define BACKGROUND (1000)
+#define BACKGROUND_MS (1)
+#define WORK_NS (20000L)
+#define RUN_NS (1000000000L)
+
+typedef struct
+{
+    long next_ns;
+} ctx_t;
+
+static sch_t *g_sch = NULL;
+static long g_end_ns = 0;
+static hist_t g_late;
+static size_t g_background_runs = 0;
+
+static int Critical(void *arg);
+static int Background(void *arg);
+static long NowNs(void);
+static void Run(const char *name, int use_wheel, int lanes,
+                                        sch_lane_policy_t policy);
+
+int main(void)
+{
+    printf("critical lane: %d tasks every %d ms, start minus deadline (us)\n"
+        "background lane: %d tasks every %d ms, %ld us each "
+        "(%ldx the loop's capacity), %.1f s per run\n",
+        CRITICAL, CRITICAL_MS, BACKGROUND, BACKGROUND_MS, WORK_NS / 1000,
+        BACKGROUND * WORK_NS / (BACKGROUND_MS * 1000000L),
+        (double)RUN_NS / 1e9);
+    printf("%-8s %-10s %10s %10s %10s %10s %12s\n", "engine", "lanes",
+                            "runs", "p50", "p99", "max", "background");
+
+    Run("heap", 0, 0, SCH_LANES_STRICT);
+    Run("heap", 0, 1, SCH_LANES_STRICT);
+    Run("heap", 0, 1, SCH_LANES_WEIGHTED);
+    Run("wheel", 1, 0, SCH_LANES_STRICT);
+    Run("wheel", 1, 1, SCH_LANES_STRICT);
+    Run("wheel", 1, 1, SCH_LANES_WEIGHTED);
+
+    return 0;
+}
+
+/* without lanes every task shares the normal lane, in deadline order */
+static void Run(const char *name, int use_wheel, int lanes,
+                                        sch_lane_policy_t policy)
+{
+    static const size_t weight[SCH_LANES] = {4, 2, 1};
+    ctx_t ctx[CRITICAL];
+    sch_attr_t attr;
+    size_t i = 0;
+
+    g_sch = use_wheel ? SchCreateWheel() : SchCreate();
+
+    if (NULL == g_sch || 0 != SchSetLanes(g_sch, policy, weight))
+    {
+        return;
+    }
+
+    HistInit(&g_late);
+    g_background_runs = 0;
+    g_end_ns = NowNs() + RUN_NS;
+
+    SchAttrInit(&attr, BACKGROUND_MS);
+    attr.lane = lanes ? SCH_LANE_BACKGROUND : SCH_LANE_NORMAL;
+
+    for (i = 0; i < BACKGROUND; ++i)
+    {
+        SchAddAttr(g_sch, &attr, Background, NULL);
+    }
+
+    /* a late critical task skips to the next tick, so is the sample */
+    SchAttrInit(&attr, CRITICAL_MS);
+    attr.overrun = SCH_SKIP;
+    attr.lane = lanes ? SCH_LANE_CRITICAL : SCH_LANE_NORMAL;
+
+    for (i = 0; i < CRITICAL; ++i)
+    {
+        ctx[i].next_ns = NowNs() + CRITICAL_MS * 1000000L;
+        SchAddAttr(g_sch, &attr, Critical, &ctx[i]);
+    }
+
+    SchRun(g_sch);
+
+    printf("%-8s %-10s %10lu %10.1f %10.1f %10.1f %12lu\n", name,
+        lanes ? ((SCH_LANES_STRICT == policy) ? "strict" : "weighted") :
+        "none", (unsigned long)g_late.count,
+        HistPercentile(&g_late, 50) / 1e3,
+        HistPercentile(&g_late, 99) / 1e3,
+        g_late.max / 1e3, (unsigned long)g_background_runs);
+
+    SchDestroy(g_sch);
+}
+
+static int Critical(void *arg)
+{
+    ctx_t *ctx = (ctx_t *)arg;
+    long now = NowNs();
+
+    HistRecord(&g_late, (now > ctx->next_ns) ? now - ctx->next_ns : 0);
+
+    while (ctx->next_ns <= now)
+    {
+        ctx->next_ns += CRITICAL_MS * 1000000L;
+    }
+
+    if (now >= g_end_ns)
+    {
+        SchStop(g_sch);
+    }
+
+    return 0;
+}
+
+static int Background(void *arg)
+{
+    long start = NowNs();
+
+    (void)arg;
+
+    while (NowNs() - start < WORK_NS)
+    {
+    }
+
+    ++g_background_runs;
+
+    if (start >= g_end_ns)
+    {
+        SchStop(g_sch);
+    }
+
+    return 0;
+}
+
+static long NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
@@ -0,0 +1,284 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* malloc           */
+#include <stddef.h>         /* offsetof         */
+#include <time.h>           /* clock_gettime    */
+
+#include "priority_q.h"
+#include "arena.h"
+
+#define MIN_QUEUE (100)
+#define MAX_QUEUE (10000)
+#define CHURN_STEPS (20000000)
+#define MIN_WALK (10000)
+#define MAX_WALK (1000000)
+#define WALKS (10)
+
+/* an element of a scheduler style queue, it carries its own link */
+typedef struct
+{
+    size_t key;
+    dlink_t link;
+} elem_t;
+
+typedef enum
+{
+    NODES_MALLOC,
+    NODES_ARENA,
+    LINKS
+} kind_t;
+
+static const char *g_names[] = {"malloc nodes", "arena nodes", "intrusive"};
+
+static void RunChurn(size_t size);
+static void RunWalk(size_t size);
+static pq_t *QueueCreate(kind_t kind, arena_t *arena);
+static sortedlist_t *ListCreate(kind_t kind, arena_t *arena);
+static int IsBefore(const void *data, const void *to_compare);
+static int SumOp(void *data, void *arg);
+static size_t Rand(size_t *seed);
+static long NowNs(void);
+
+int main(void)
+{
+    size_t size = 0;
+
+    printf("list priority queue, dequeue the first and enqueue it with a "
+                                        "later key, ns per dequeue+enqueue\n");
+    printf("%10s %14s %14s %14s\n", "size", g_names[NODES_MALLOC],
+                                    g_names[NODES_ARENA], g_names[LINKS]);
+
+    for (size = MIN_QUEUE; size <= MAX_QUEUE; size *= 10)
+    {
+        RunChurn(size);
+    }
+
+    printf("\nsorted list, elements in random memory order, "
+                                    "SortedListForEach ns per element\n");
+    printf("%10s %14s %14s %14s\n", "size", g_names[NODES_MALLOC],
+                                    g_names[NODES_ARENA], g_names[LINKS]);
+
+    for (size = MIN_WALK; size <= MAX_WALK; size *= 10)
+    {
+        RunWalk(size);
+    }
+
+    return 0;
+}
+
+static void RunChurn(size_t size)
+{
+    elem_t *elems = (elem_t *)malloc(size * sizeof(elem_t));
+    double ns[3] = {0};
+    size_t churn = CHURN_STEPS / size;
+    kind_t kind = NODES_MALLOC;
+
+    if (NULL == elems)
+    {
+        return;
+    }
+
+    for (kind = NODES_MALLOC; kind <= LINKS; ++kind)
+    {
+        arena_t *arena = ArenaCreate(0);
+        pq_t *pq = QueueCreate(kind, arena);
+        size_t seed = 12345;
+        long start = 0;
+        size_t i = 0;
+
+        if (NULL == pq)
+        {
+            ArenaDestroy(arena);
+            continue;
+        }
+
+        for (i = 0; i < size; ++i)
+        {
+            elems[i].key = Rand(&seed) % (size * 16);
+            PriorityQEnqueue(pq, &elems[i]);
+        }
+
+        start = NowNs();
+
+        for (i = 0; i < churn; ++i)
+        {
+            elem_t *elem = (elem_t *)PriorityQPeek(pq);
+
+            PriorityQDequeue(pq);
+            elem->key += Rand(&seed) % (size * 16);
+            PriorityQEnqueue(pq, elem);
+        }
+
+        ns[kind] = (double)(NowNs() - start) / churn;
+
+        PriorityQDestroy(pq);
+        ArenaDestroy(arena);
+    }
+
+    printf("%10lu %14.1f %14.1f %14.1f\n", (unsigned long)size,
+                                ns[NODES_MALLOC], ns[NODES_ARENA], ns[LINKS]);
+
+    free(elems);
+}
+
+static void RunWalk(size_t size)
+{
+    elem_t *elems = (elem_t *)malloc(size * sizeof(elem_t));
+    size_t *order = (size_t *)malloc(size * sizeof(size_t));
+    sliter_t *iters = (sliter_t *)malloc(size * sizeof(sliter_t));
+    double ns[3] = {0};
+    size_t seed = 12345;
+    kind_t kind = NODES_MALLOC;
+    size_t i = 0;
+
+    if (NULL == elems || NULL == order || NULL == iters)
+    {
+        free(elems);
+        free(order);
+        free(iters);
+
+        return;
+    }
+
+    for (i = 0; i < size; ++i)
+    {
+        order[i] = i;
+    }
+
+    for (i = size - 1; 0 < i; --i)
+    {
+        size_t j = Rand(&seed) % (i + 1);
+        size_t tmp = order[i];
+
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    for (kind = NODES_MALLOC; kind <= LINKS; ++kind)
+    {
+        arena_t *arena = ArenaCreate(0);
+        sortedlist_t *list = ListCreate(kind, arena);
+        size_t sum = 0;
+        long start = 0;
+
+        if (NULL == list)
+        {
+            ArenaDestroy(arena);
+            continue;
+        }
+
+        /*
+            larger keys sort first, so every insert lands at the front.
+            The first fill is erased in random order, so the nodes of
+            the second come back from malloc or the pool scattered too.
+        */
+        for (i = 0; i < size; ++i)
+        {
+            elems[order[i]].key = i + 1;
+            iters[order[i]] = SortedListInsert(list, &elems[order[i]]);
+        }
+
+        for (i = 0; i < size; ++i)
+        {
+            SortedListErase(iters[i]);
+        }
+
+        for (i = 0; i < size; ++i)
+        {
+            SortedListInsert(list, &elems[order[i]]);
+        }
+
+        start = NowNs();
+
+        for (i = 0; i < WALKS; ++i)
+        {
+            SortedListForEach(SortedListBegin(list), SortedListEnd(list),
+                                                                SumOp, &sum);
+        }
+
+        ns[kind] = (double)(NowNs() - start) / WALKS / size;
+
+        /* keeps the walk from being optimized away */
+        if (sum != WALKS * size * (size + 1) / 2)
+        {
+            printf("bad sum\n");
+        }
+
+        SortedListDestroy(list);
+        ArenaDestroy(arena);
+    }
+
+    printf("%10lu %14.2f %14.2f %14.2f\n", (unsigned long)size,
+                                ns[NODES_MALLOC], ns[NODES_ARENA], ns[LINKS]);
+
+    free(elems);
+    free(order);
+    free(iters);
+}
+
+static pq_t *QueueCreate(kind_t kind, arena_t *arena)
+{
+    switch (kind)
+    {
+        case NODES_MALLOC:
+            return PriorityQCreate(IsBefore);
+
+        case NODES_ARENA:
+            return (NULL == arena) ? NULL :
+                                PriorityQCreateFromArena(IsBefore, arena);
+
+        case LINKS:
+            return PriorityQCreateIntrusive(IsBefore, offsetof(elem_t, link));
+    }
+
+    return NULL;
+}
+
+static sortedlist_t *ListCreate(kind_t kind, arena_t *arena)
+{
+    switch (kind)
+    {
+        case NODES_MALLOC:
+            return SortedListCreate(IsBefore);
+
+        case NODES_ARENA:
+            return (NULL == arena) ? NULL :
+                                SortedListCreateFromArena(IsBefore, arena);
+
+        case LINKS:
+            return SortedListCreateIntrusive(IsBefore,
+                                                    offsetof(elem_t, link));
+    }
+
+    return NULL;
+}
+
+/* the list queue serves from its back, the smallest key */
+static int IsBefore(const void *data, const void *to_compare)
+{
+    return ((const elem_t *)data)->key > ((const elem_t *)to_compare)->key;
+}
+
+static int SumOp(void *data, void *arg)
+{
+    *(size_t *)arg += ((elem_t *)data)->key;
+
+    return 0;
+}
+
+static size_t Rand(size_t *seed)
+{
+    *seed = *seed * 6364136223846793005UL + 1442695040888963407UL;
+
+    return *seed >> 33;
+}
+
+static long NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
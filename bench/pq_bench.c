@@ -0,0 +1,130 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* malloc           */
+#include <time.h>           /* clock_gettime    */
+
+#include "priority_q.h"
+
+#define MIN_TASKS (1000)
+#define MAX_TASKS (1000000)
+#define HEAP_OPS (1000000)
+#define LIST_BUDGET (100000000)
+#define LIST_MIN_OPS (20)
+
+typedef struct
+{
+    size_t key;
+} item_t;
+
+static int IsBefore(const void *data, const void *to_compare);
+static double NowNs(void);
+static size_t Rand(void);
+static void Run(const char *name, pq_t *pq, item_t *items, size_t n,
+                                                            size_t ops);
+
+int main(void)
+{
+    item_t *items = (item_t *)malloc(MAX_TASKS * sizeof(item_t));
+    size_t n = 0;
+
+    if (NULL == items)
+    {
+        return 1;
+    }
+
+    printf("%-8s %10s %14s %14s\n", "backend", "tasks", "fill ns/op",
+                                                        "resched ns/op");
+
+    for (n = MIN_TASKS; n <= MAX_TASKS; n *= 10)
+    {
+        size_t list_ops = LIST_BUDGET / n;
+
+        if (list_ops < LIST_MIN_OPS)
+        {
+            list_ops = LIST_MIN_OPS;
+        }
+
+        Run("list", PriorityQCreate(IsBefore), items, n, list_ops);
+        Run("heap", PriorityQCreateHeap(IsBefore, 0), items, n, HEAP_OPS);
+    }
+
+    free(items);
+
+    return 0;
+}
+
+/*
+    fills the queue with n tasks, then measures ops reschedules:
+    peek, dequeue, push the deadline forward and enqueue again.
+*/
+static void Run(const char *name, pq_t *pq, item_t *items, size_t n,
+                                                            size_t ops)
+{
+    double start = 0;
+    double fill = 0;
+    double resched = 0;
+    size_t i = 0;
+
+    if (NULL == pq)
+    {
+        printf("%-8s %10lu   create failed\n", name, (unsigned long)n);
+
+        return;
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < n; ++i)
+    {
+        items[i].key = i;
+        PriorityQEnqueue(pq, &items[i]);
+    }
+
+    fill = NowNs() - start;
+    start = NowNs();
+
+    for (i = 0; i < ops; ++i)
+    {
+        item_t *item = PriorityQPeek(pq);
+
+        PriorityQDequeue(pq);
+        item->key += 1 + Rand() % n;
+        PriorityQEnqueue(pq, item);
+    }
+
+    resched = NowNs() - start;
+
+    printf("%-8s %10lu %14.1f %14.1f\n", name, (unsigned long)n,
+                                            fill / n, resched / ops);
+
+    PriorityQDestroy(pq);
+}
+
+static int IsBefore(const void *data, const void *to_compare)
+{
+    const item_t *item = data;
+    const item_t *item_to_compare = to_compare;
+
+    return ((item->key < item_to_compare->key) ? 0 : 1);
+}
+
+static double NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+static size_t Rand(void)
+{
+    static unsigned long state = 88172645463325252UL;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return (size_t)state;
+}
@@ -0,0 +1,122 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* malloc           */
+#include <time.h>           /* clock_gettime    */
+
+#include "scheduler.h"
+
+#define MIN_TASKS (1000)
+#define MAX_TASKS (1000000)
+#define OPS (200000)
+
+typedef enum
+{
+    REMOVE_ADD,
+    RESCHEDULE,
+    SET_INTERVAL
+} op_t;
+
+static int Noop(void *arg);
+static long NowNs(void);
+static void Run(const char *name, int use_wheel, size_t tasks);
+static double Measure(sch_t *sch, ilrd_uid_t *uids, size_t tasks, op_t op);
+
+int main(void)
+{
+    size_t tasks = 0;
+
+    printf("changing the interval of a queued task, ns per change\n");
+    printf("%-8s %10s %14s %14s %14s\n", "engine", "tasks", "remove+add",
+                                            "reschedule", "set interval");
+
+    for (tasks = MIN_TASKS; tasks <= MAX_TASKS; tasks *= 10)
+    {
+        Run("heap", 0, tasks);
+        Run("wheel", 1, tasks);
+    }
+
+    return 0;
+}
+
+static void Run(const char *name, int use_wheel, size_t tasks)
+{
+    ilrd_uid_t *uids = (ilrd_uid_t *)malloc(tasks * sizeof(ilrd_uid_t));
+    sch_t *sch = use_wheel ? SchCreateWheel() : SchCreate();
+    double ns[3] = {0};
+    size_t i = 0;
+
+    if (NULL == uids || NULL == sch)
+    {
+        free(uids);
+
+        return;
+    }
+
+    for (i = 0; i < tasks; ++i)
+    {
+        uids[i] = SchAdd(sch, 60000 + i % 60000, Noop, NULL);
+    }
+
+    ns[REMOVE_ADD] = Measure(sch, uids, tasks, REMOVE_ADD);
+    ns[RESCHEDULE] = Measure(sch, uids, tasks, RESCHEDULE);
+    ns[SET_INTERVAL] = Measure(sch, uids, tasks, SET_INTERVAL);
+
+    printf("%-8s %10lu %14.1f %14.1f %14.1f\n", name, (unsigned long)tasks,
+                        ns[REMOVE_ADD], ns[RESCHEDULE], ns[SET_INTERVAL]);
+
+    SchDestroy(sch);
+    free(uids);
+}
+
+/* random tasks get random new intervals, they stay far in the future */
+static double Measure(sch_t *sch, ilrd_uid_t *uids, size_t tasks, op_t op)
+{
+    size_t seed = 12345;
+    long start = NowNs();
+    size_t i = 0;
+
+    for (i = 0; i < OPS; ++i)
+    {
+        size_t index = 0;
+        size_t interval = 0;
+
+        seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+        index = (seed >> 33) % tasks;
+        interval = 60000 + (seed >> 13) % 60000;
+
+        switch (op)
+        {
+            case REMOVE_ADD:
+                SchRemove(sch, uids[index]);
+                uids[index] = SchAdd(sch, interval, Noop, NULL);
+                break;
+
+            case RESCHEDULE:
+                SchReschedule(sch, uids[index], interval);
+                break;
+
+            case SET_INTERVAL:
+                SchSetInterval(sch, uids[index], interval);
+                break;
+        }
+    }
+
+    return (double)(NowNs() - start) / OPS;
+}
+
+static int Noop(void *arg)
+{
+    (void)arg;
+
+    return 0;
+}
+
+static long NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
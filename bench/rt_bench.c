@@ -0,0 +1,211 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* malloc, qsort    */
+#include <time.h>           /* clock_gettime    */
+#include <pthread.h>        /* pthread_create   */
+#include <signal.h>         /* kill             */
+#include <unistd.h>         /* fork, sysconf    */
+#include <sys/wait.h>       /* waitpid          */
+
+#include "scheduler.h"
+#include "watch_dog.h"
+
+#define LOAD_PER_CPU (4)
+#define MAX_LOAD (256)
+#define HEARTBEAT_MS (10)
+#define RUN_MS (3000)
+#define MAX_SAMPLES (RUN_MS / HEARTBEAT_MS + 16)
+
+/*
+    a heartbeat thread like the watch dog's, on its own scheduler,
+    while LOAD_PER_CPU spinning processes per CPU saturate the machine
+*/
+typedef struct
+{
+    long next_ns;
+} ctx_t;
+
+static sch_t *g_sch = NULL;
+static long g_samples[MAX_SAMPLES];
+static size_t g_count = 0;
+
+static void Run(const char *name, size_t load, const wd_options_t *options);
+static void *HeartbeatThread(void *arg);
+static int Heartbeat(void *arg);
+static int Stop(void *arg);
+static size_t StartLoad(pid_t *pids, size_t count);
+static void StopLoad(pid_t *pids, size_t count);
+static int CmpLong(const void *a, const void *b);
+static long NowNs(void);
+
+int main(void)
+{
+    wd_options_t options;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t load = (size_t)((0 < cpus) ? cpus : 1) * LOAD_PER_CPU;
+
+    load = (load < MAX_LOAD) ? load : MAX_LOAD;
+
+    printf("heartbeat every %d ms, %.1f s per run, start minus deadline "
+                "(us), load: %lu spinning processes\n", HEARTBEAT_MS,
+                RUN_MS / 1e3, (unsigned long)load);
+    printf("%-22s %8s %10s %10s %10s %10s %8s\n", "options", "load",
+                            "samples", "p50", "p99", "max", "missed");
+
+    WDOptionsInit(&options);
+    Run("default", 0, &options);
+    Run("default", load, &options);
+
+    options.lock_memory = 1;
+    options.cpu = 0;
+    Run("pinned, locked", load, &options);
+
+    options.policy = WD_SCHED_RR;
+    Run("rr, pinned, locked", load, &options);
+
+    options.policy = WD_SCHED_FIFO;
+    Run("fifo, pinned, locked", load, &options);
+
+    return 0;
+}
+
+static void Run(const char *name, size_t load, const wd_options_t *options)
+{
+    pid_t pids[MAX_LOAD];
+    pthread_t thread;
+    size_t missed = 0;
+    size_t started = StartLoad(pids, load);
+    size_t i = 0;
+
+    g_count = 0;
+
+    if (0 == pthread_create(&thread, NULL, HeartbeatThread, (void *)options))
+    {
+        pthread_join(thread, NULL);
+    }
+
+    StopLoad(pids, started);
+
+    if (0 == g_count)
+    {
+        return;
+    }
+
+    for (i = 0; i < g_count; ++i)
+    {
+        missed += (g_samples[i] >= HEARTBEAT_MS * 1000000L);
+    }
+
+    qsort(g_samples, g_count, sizeof(long), CmpLong);
+
+    printf("%-22s %8lu %10lu %10.1f %10.1f %10.1f %8lu\n", name,
+        (unsigned long)started, (unsigned long)g_count,
+        g_samples[g_count / 2] / 1e3, g_samples[g_count * 99 / 100] / 1e3,
+        g_samples[g_count - 1] / 1e3, (unsigned long)missed);
+}
+
+/* the options apply to this thread only, as in WDKeepAliveOpt */
+static void *HeartbeatThread(void *arg)
+{
+    ctx_t ctx = {0};
+
+    if (0 != WDApplyOptions((const wd_options_t *)arg))
+    {
+        printf("(fell back to the defaults)\n");
+    }
+
+    g_sch = SchCreate();
+
+    if (NULL == g_sch)
+    {
+        return NULL;
+    }
+
+    ctx.next_ns = NowNs() + HEARTBEAT_MS * 1000000L;
+    SchAdd(g_sch, HEARTBEAT_MS, Heartbeat, &ctx);
+    SchAdd(g_sch, RUN_MS, Stop, NULL);
+    SchRun(g_sch);
+    SchDestroy(g_sch);
+
+    return NULL;
+}
+
+static int Heartbeat(void *arg)
+{
+    ctx_t *ctx = (ctx_t *)arg;
+    long late = NowNs() - ctx->next_ns;
+
+    if (g_count < MAX_SAMPLES)
+    {
+        g_samples[g_count++] = (0 < late) ? late : 0;
+    }
+
+    ctx->next_ns += HEARTBEAT_MS * 1000000L;
+
+    return 0;
+}
+
+static int Stop(void *arg)
+{
+    (void)arg;
+
+    SchStop(g_sch);
+
+    return 1;
+}
+
+static size_t StartLoad(pid_t *pids, size_t count)
+{
+    size_t started = 0;
+
+    for (started = 0; started < count; ++started)
+    {
+        pids[started] = fork();
+
+        if (0 == pids[started])
+        {
+            volatile unsigned long spin = 0;
+
+            for (;;)
+            {
+                ++spin;
+            }
+        }
+
+        if (0 > pids[started])
+        {
+            break;
+        }
+    }
+
+    return started;
+}
+
+static void StopLoad(pid_t *pids, size_t count)
+{
+    size_t i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        kill(pids[i], SIGKILL);
+        waitpid(pids[i], NULL, 0);
+    }
+}
+
+static int CmpLong(const void *a, const void *b)
+{
+    long x = *(const long *)a;
+    long y = *(const long *)b;
+
+    return (x > y) - (x < y);
+}
+
+static long NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
@@ -0,0 +1,201 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <time.h>           /* clock_gettime    */
+
+#include "scheduler.h"
+
+#define HEARTBEAT_MS (1000)
+#define ATTEMPT_NUM (4)
+#define CRASH_MS (420000)
+#define HOUR_MS (3600000)
+#define MAX_LOAD (10000)
+
+/*
+    the watch dog's heartbeat logic on a simulated clock: each side
+    counts the beats it sent, a beat from the other side resets the
+    count, ATTEMPT_NUM unanswered beats revive the other side.
+    A crash task kills the app and the watch dog in turn.
+*/
+typedef struct
+{
+    int alive;
+    size_t counter;
+    long down_at;
+} peer_t;
+
+static sch_t *g_sch = NULL;
+static peer_t g_peers[2];
+static size_t g_beats = 0;
+static size_t g_failovers = 0;
+static long g_detect_min = 0;
+static long g_detect_max = 0;
+static size_t g_crashes = 0;
+
+static int SendBeat(void *arg);
+static int CheckCounter(void *arg);
+static int Crash(void *arg);
+static int Stop(void *arg);
+static int Noop(void *arg);
+static long SchNowMs(void);
+static double NowMs(void);
+static void Run(const char *name, int use_wheel, size_t load);
+
+int main(void)
+{
+    size_t load = 0;
+
+    printf("one simulated hour: heartbeat %d ms, a crash every %d s, "
+                        "plus load tasks every 1-60 s\n", HEARTBEAT_MS,
+                        CRASH_MS / 1000);
+    printf("%-8s %8s %10s %10s %10s %12s %12s %10s\n", "engine", "load",
+        "beats", "failovers", "real ms", "sim x", "detect min", "detect max");
+
+    for (load = 0; load <= MAX_LOAD; load = (0 == load) ? 1000 : load * 10)
+    {
+        Run("heap", 0, load);
+        Run("wheel", 1, load);
+    }
+
+    return 0;
+}
+
+static void Run(const char *name, int use_wheel, size_t load)
+{
+    struct timespec now = {0};
+    sch_clock_t clock;
+    double start = 0;
+    size_t i = 0;
+
+    g_sch = use_wheel ? SchCreateWheel() : SchCreate();
+    SchVirtualClock(&clock, &now);
+
+    if (NULL == g_sch || 0 != SchSetClock(g_sch, &clock))
+    {
+        return;
+    }
+
+    for (i = 0; i < 2; ++i)
+    {
+        g_peers[i].alive = 1;
+        g_peers[i].counter = 0;
+        g_peers[i].down_at = 0;
+        SchAdd(g_sch, HEARTBEAT_MS, SendBeat, &g_peers[i]);
+        SchAdd(g_sch, HEARTBEAT_MS, CheckCounter, &g_peers[i]);
+    }
+
+    for (i = 0; i < load; ++i)
+    {
+        SchAdd(g_sch, 1000 * (1 + i % 60), Noop, NULL);
+    }
+
+    SchAdd(g_sch, CRASH_MS, Crash, NULL);
+    SchAdd(g_sch, HOUR_MS, Stop, NULL);
+
+    g_beats = 0;
+    g_failovers = 0;
+    g_crashes = 0;
+    g_detect_min = HOUR_MS;
+    g_detect_max = 0;
+
+    start = NowMs();
+    SchRun(g_sch);
+    start = NowMs() - start;
+
+    printf("%-8s %8lu %10lu %10lu %10.1f %12.0f %9ld ms %9ld ms\n", name,
+        (unsigned long)load, (unsigned long)g_beats,
+        (unsigned long)g_failovers, start, HOUR_MS / start,
+        g_detect_min, g_detect_max);
+
+    SchDestroy(g_sch);
+}
+
+static int SendBeat(void *arg)
+{
+    peer_t *self = (peer_t *)arg;
+    peer_t *other = (self == &g_peers[0]) ? &g_peers[1] : &g_peers[0];
+
+    if (!self->alive)
+    {
+        return 0;
+    }
+
+    ++g_beats;
+    ++self->counter;
+
+    if (other->alive)
+    {
+        other->counter = 0;
+    }
+
+    return 0;
+}
+
+static int CheckCounter(void *arg)
+{
+    peer_t *self = (peer_t *)arg;
+    peer_t *other = (self == &g_peers[0]) ? &g_peers[1] : &g_peers[0];
+    long detect = 0;
+
+    if (!self->alive || self->counter < ATTEMPT_NUM)
+    {
+        return 0;
+    }
+
+    detect = SchNowMs() - other->down_at;
+    g_detect_min = (detect < g_detect_min) ? detect : g_detect_min;
+    g_detect_max = (detect > g_detect_max) ? detect : g_detect_max;
+    ++g_failovers;
+
+    other->alive = 1;
+    other->counter = 0;
+    self->counter = 0;
+
+    return 0;
+}
+
+static int Crash(void *arg)
+{
+    peer_t *victim = &g_peers[g_crashes++ % 2];
+
+    (void)arg;
+
+    victim->alive = 0;
+    victim->down_at = SchNowMs();
+
+    return 0;
+}
+
+static int Stop(void *arg)
+{
+    (void)arg;
+
+    SchStop(g_sch);
+
+    return 1;
+}
+
+static int Noop(void *arg)
+{
+    (void)arg;
+
+    return 0;
+}
+
+static long SchNowMs(void)
+{
+    struct timespec now = {0};
+
+    SchNow(g_sch, &now);
+
+    return now.tv_sec * 1000L + now.tv_nsec / 1000000L;
+}
+
+static double NowMs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
@@ -0,0 +1,118 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <time.h>           /* clock_gettime    */
+
+#include "priority_q.h"
+
+#define MIN_SIZE (1000)
+#define MAX_SIZE (1000000)
+#define POLLS (1000000)
+#define WALK_STEPS (100000000)
+
+static void Run(size_t size);
+static int IsBefore(const void *data, const void *to_compare);
+static int CountOp(void *data, void *arg);
+static long NowNs(void);
+
+static size_t g_keys[MAX_SIZE];
+
+int main(void)
+{
+    size_t size = 0;
+
+    printf("polling the depth of a list priority queue, ns per poll\n");
+    printf("%10s %14s %14s %14s\n", "size", "walk", "PQSize", "PQStats");
+
+    for (size = MIN_SIZE; size <= MAX_SIZE; size *= 10)
+    {
+        Run(size);
+    }
+
+    return 0;
+}
+
+/* the walk is what a size query cost before the queues kept a count */
+static void Run(size_t size)
+{
+    sortedlist_t *list = SortedListCreate(IsBefore);
+    pq_t *pq = PriorityQCreate(IsBefore);
+    volatile size_t sink = 0;
+    size_t walks = WALK_STEPS / size;
+    pq_stats_t stats;
+    double ns[3] = {0};
+    long start = 0;
+    size_t i = 0;
+
+    if (NULL == list || NULL == pq)
+    {
+        return;
+    }
+
+    /* smallest key last, so every insert stops at the front */
+    for (i = 0; i < size; ++i)
+    {
+        g_keys[i] = size - i;
+        SortedListInsert(list, &g_keys[i]);
+        PriorityQEnqueue(pq, &g_keys[i]);
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < walks; ++i)
+    {
+        size_t count = 0;
+
+        SortedListForEach(SortedListBegin(list), SortedListEnd(list),
+                                                        CountOp, &count);
+        sink = count;
+    }
+
+    ns[0] = (double)(NowNs() - start) / walks;
+    start = NowNs();
+
+    for (i = 0; i < POLLS; ++i)
+    {
+        sink = PriorityQSize(pq);
+    }
+
+    ns[1] = (double)(NowNs() - start) / POLLS;
+    start = NowNs();
+
+    for (i = 0; i < POLLS; ++i)
+    {
+        PriorityQStats(pq, &stats);
+        sink = stats.size;
+    }
+
+    ns[2] = (double)(NowNs() - start) / POLLS;
+    (void)sink;
+
+    printf("%10lu %14.1f %14.1f %14.1f\n", (unsigned long)size,
+                                                    ns[0], ns[1], ns[2]);
+
+    SortedListDestroy(list);
+    PriorityQDestroy(pq);
+}
+
+static int IsBefore(const void *data, const void *to_compare)
+{
+    return *(const size_t *)data < *(const size_t *)to_compare;
+}
+
+static int CountOp(void *data, void *arg)
+{
+    (void)data;
+    ++*(size_t *)arg;
+
+    return 0;
+}
+
+static long NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
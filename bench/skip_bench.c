@@ -0,0 +1,138 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* malloc           */
+#include <time.h>           /* clock_gettime    */
+
+#include "sorted_ll.h"
+
+#define MIN_SIZE (1000)
+#define MAX_SIZE (1000000)
+#define OPS (1000)
+#define LIST_STEPS (100000000)
+
+typedef enum
+{
+    INSERT,
+    SEARCH,
+    ERASE
+} op_t;
+
+static void Run(size_t size);
+static void Measure(sortedlist_t *list, size_t *keys, size_t size,
+                                                    size_t ops, double *ns);
+static int IsBefore(const void *data, const void *to_compare);
+static long NowNs(void);
+
+int main(void)
+{
+    size_t size = 0;
+
+    printf("ns per operation on a list of the given size, random keys\n");
+    printf("%10s %12s %12s %12s %12s %12s %12s\n", "size", "list ins",
+        "skip ins", "list search", "skip search", "list erase", "skip erase");
+
+    for (size = MIN_SIZE; size <= MAX_SIZE; size *= 10)
+    {
+        Run(size);
+    }
+
+    return 0;
+}
+
+static void Run(size_t size)
+{
+    size_t *keys = (size_t *)malloc((size + OPS) * sizeof(size_t));
+    sortedlist_t *list = SortedListCreate(IsBefore);
+    sortedlist_t *skip = SortedListCreateSkip(IsBefore);
+    double list_ns[3] = {0};
+    double skip_ns[3] = {0};
+    size_t list_ops = (LIST_STEPS / size < OPS) ? LIST_STEPS / size : OPS;
+    size_t i = 0;
+
+    if (NULL == keys || NULL == list || NULL == skip)
+    {
+        free(keys);
+
+        return;
+    }
+
+    /* even keys, largest first, so the list fills from the front */
+    for (i = 0; i < size; ++i)
+    {
+        keys[i] = 2 * (size - i);
+        SortedListInsert(list, &keys[i]);
+        SortedListInsert(skip, &keys[i]);
+    }
+
+    Measure(list, keys, size, list_ops, list_ns);
+    Measure(skip, keys, size, OPS, skip_ns);
+
+    printf("%10lu %12.1f %12.1f %12.1f %12.1f %12.1f %12.1f\n",
+        (unsigned long)size, list_ns[INSERT], skip_ns[INSERT],
+        list_ns[SEARCH], skip_ns[SEARCH], list_ns[ERASE], skip_ns[ERASE]);
+
+    SortedListDestroy(list);
+    SortedListDestroy(skip);
+    free(keys);
+}
+
+/*
+    ops odd keys go in, ops even keys are searched, the odd ones leave.
+    The list walks O(n) per insert, so it does fewer ops on large sizes.
+*/
+static void Measure(sortedlist_t *list, size_t *keys, size_t size,
+                                                    size_t ops, double *ns)
+{
+    static sliter_t iters[OPS];
+    size_t seed = 12345;
+    long start = 0;
+    size_t i = 0;
+
+    for (i = 0; i < ops; ++i)
+    {
+        seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+        keys[size + i] = 2 * ((seed >> 33) % size) + 1;
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < ops; ++i)
+    {
+        iters[i] = SortedListInsert(list, &keys[size + i]);
+    }
+
+    ns[INSERT] = (double)(NowNs() - start) / ops;
+    start = NowNs();
+
+    for (i = 0; i < ops; ++i)
+    {
+        size_t key = keys[size + i] + 1;
+
+        SortedListSearch(list, &key);
+    }
+
+    ns[SEARCH] = (double)(NowNs() - start) / ops;
+    start = NowNs();
+
+    for (i = 0; i < ops; ++i)
+    {
+        SortedListErase(iters[i]);
+    }
+
+    ns[ERASE] = (double)(NowNs() - start) / ops;
+}
+
+static int IsBefore(const void *data, const void *to_compare)
+{
+    return *(const size_t *)data < *(const size_t *)to_compare;
+}
+
+static long NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
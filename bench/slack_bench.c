@@ -0,0 +1,211 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* malloc           */
+#include <time.h>           /* clock_nanosleep  */
+
+#include "scheduler.h"
+
+#define TASKS (10000)
+#define PERIOD_MS (1000)
+#define SIM_MS (60000)
+#define REAL_MS (3000)
+
+/*
+    TASKS heartbeats of PERIOD_MS, started at even offsets across one
+    period, so without slack no two are due at the same time.
+    The clock is simulated or real, plus a shift that moves it to each
+    task's offset while the tasks are added. It counts the sleeps that
+    end in a wakeup.
+*/
+typedef struct
+{
+    long next_ns;
+} ctx_t;
+
+typedef struct
+{
+    int real;
+    long sim_ns;
+    long shift_ns;
+    size_t wakeups;
+} clock_ctx_t;
+
+static sch_t *g_sch = NULL;
+static ctx_t *g_ctx = NULL;
+static size_t g_runs = 0;
+static long g_max_late = 0;
+static double g_sum_late = 0;
+
+static void Run(const char *name, int use_wheel, size_t slack, int real);
+static int Heartbeat(void *arg);
+static int Stop(void *arg);
+static void ShiftNow(struct timespec *now, void *arg);
+static void ShiftSleep(const struct timespec *deadline, void *arg);
+static long TimeToNs(const struct timespec *time);
+static struct timespec NsToTime(long ns);
+
+int main(void)
+{
+    static const size_t slacks[] = {0, 1, 5, 10, 50, 100};
+    size_t i = 0;
+
+    g_ctx = (ctx_t *)malloc(TASKS * sizeof(ctx_t));
+
+    if (NULL == g_ctx)
+    {
+        return 1;
+    }
+
+    printf("%d tasks every %d ms at even offsets, %d simulated s\n",
+                                        TASKS, PERIOD_MS, SIM_MS / 1000);
+    printf("%-8s %8s %12s %12s %12s %12s\n", "engine", "slack ms",
+                    "wakeups/s", "runs/wakeup", "mean late ms", "max late ms");
+
+    for (i = 0; i < sizeof(slacks) / sizeof(slacks[0]); ++i)
+    {
+        Run("heap", 0, slacks[i], 0);
+        Run("wheel", 1, slacks[i], 0);
+    }
+
+    printf("\nsame on the real clock, %d s\n", REAL_MS / 1000);
+
+    Run("heap", 0, 0, 1);
+    Run("heap", 0, 50, 1);
+    Run("wheel", 1, 0, 1);
+    Run("wheel", 1, 50, 1);
+
+    free(g_ctx);
+
+    return 0;
+}
+
+static void Run(const char *name, int use_wheel, size_t slack, int real)
+{
+    struct timespec now = {0};
+    clock_ctx_t clock_ctx = {0};
+    sch_clock_t clock;
+    sch_attr_t attr;
+    long run_ms = real ? REAL_MS : SIM_MS;
+    size_t i = 0;
+
+    clock_ctx.real = real;
+    clock.now = ShiftNow;
+    clock.sleep_until = ShiftSleep;
+    clock.arg = &clock_ctx;
+
+    g_sch = use_wheel ? SchCreateWheel() : SchCreate();
+
+    if (NULL == g_sch || 0 != SchSetClock(g_sch, &clock))
+    {
+        return;
+    }
+
+    SchAttrInit(&attr, PERIOD_MS);
+    attr.slack = slack;
+
+    for (i = 0; i < TASKS; ++i)
+    {
+        clock_ctx.shift_ns = (long)(i * (PERIOD_MS * 1000000.0 / TASKS));
+        SchNow(g_sch, &now);
+        g_ctx[i].next_ns = TimeToNs(&now) + PERIOD_MS * 1000000L;
+        SchAddAttr(g_sch, &attr, Heartbeat, &g_ctx[i]);
+    }
+
+    /* the first heartbeats are due from here on */
+    SchAdd(g_sch, run_ms, Stop, NULL);
+    clock_ctx.wakeups = 0;
+    g_runs = 0;
+    g_max_late = 0;
+    g_sum_late = 0;
+
+    SchRun(g_sch);
+
+    printf("%-8s %8lu %12.0f %12.1f %12.2f %12.2f\n", name,
+        (unsigned long)slack, clock_ctx.wakeups * 1000.0 / run_ms,
+        (double)g_runs / (clock_ctx.wakeups ? clock_ctx.wakeups : 1),
+        g_sum_late / (g_runs ? g_runs : 1) / 1e6, g_max_late / 1e6);
+
+    SchDestroy(g_sch);
+}
+
+static int Heartbeat(void *arg)
+{
+    ctx_t *ctx = (ctx_t *)arg;
+    struct timespec now = {0};
+    long late = 0;
+
+    SchNow(g_sch, &now);
+    late = TimeToNs(&now) - ctx->next_ns;
+    late = (0 < late) ? late : 0;
+    g_max_late = (late > g_max_late) ? late : g_max_late;
+    g_sum_late += late;
+    ctx->next_ns += PERIOD_MS * 1000000L;
+    ++g_runs;
+
+    return 0;
+}
+
+static int Stop(void *arg)
+{
+    (void)arg;
+
+    SchStop(g_sch);
+
+    return 1;
+}
+
+static void ShiftNow(struct timespec *now, void *arg)
+{
+    clock_ctx_t *ctx = (clock_ctx_t *)arg;
+
+    if (ctx->real)
+    {
+        clock_gettime(CLOCK_MONOTONIC, now);
+        *now = NsToTime(TimeToNs(now) + ctx->shift_ns);
+
+        return;
+    }
+
+    *now = NsToTime(ctx->sim_ns + ctx->shift_ns);
+}
+
+static void ShiftSleep(const struct timespec *deadline, void *arg)
+{
+    clock_ctx_t *ctx = (clock_ctx_t *)arg;
+    struct timespec now = {0};
+    struct timespec target = NsToTime(TimeToNs(deadline) - ctx->shift_ns);
+
+    ShiftNow(&now, ctx);
+
+    if (TimeToNs(&now) >= TimeToNs(deadline))
+    {
+        return;
+    }
+
+    ++ctx->wakeups;
+
+    if (ctx->real)
+    {
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, NULL);
+
+        return;
+    }
+
+    ctx->sim_ns = TimeToNs(&target);
+}
+
+static long TimeToNs(const struct timespec *time)
+{
+    return time->tv_sec * 1000000000L + time->tv_nsec;
+}
+
+static struct timespec NsToTime(long ns)
+{
+    struct timespec time = {0};
+
+    time.tv_sec = ns / 1000000000L;
+    time.tv_nsec = ns % 1000000000L;
+
+    return time;
+}
@@ -0,0 +1,183 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <time.h>           /* clock_gettime    */
+#include <unistd.h>         /* fork, pipe       */
+#include <sys/stat.h>       /* stat             */
+#include <sys/wait.h>       /* waitpid          */
+
+#include "scheduler.h"
+
+#define MIN_TASKS (1000)
+#define MAX_TASKS (1000000)
+#define PROBE_MS (5000)
+#define PROBE_KEY (1)
+#define SNAP_PATH "/tmp/sch_snap_bench.bin"
+
+typedef struct
+{
+    double load_ms;
+    size_t restored;
+    double probe_us;
+} result_t;
+
+static sch_t *g_sch = NULL;
+static long g_probe_due = 0;
+static result_t g_result = {0};
+
+static void Run(size_t tasks);
+static void Restore(int fd);
+static int Bind(size_t key, opt_t *operation, void **arg, void *param);
+static int Probe(void *arg);
+static int Noop(void *arg);
+static long NowNs(void);
+
+int main(void)
+{
+    size_t tasks = 0;
+
+    printf("save, then a forked process restores and waits for a probe "
+                                    "task due %d ms after it was added\n",
+                                    PROBE_MS);
+    printf("%10s %10s %10s %10s %10s %10s %12s\n", "tasks", "add ms",
+                "save ms", "load ms", "file KiB", "restored", "probe us");
+
+    for (tasks = MIN_TASKS; tasks <= MAX_TASKS; tasks *= 10)
+    {
+        Run(tasks);
+    }
+
+    remove(SNAP_PATH);
+
+    return 0;
+}
+
+static void Run(size_t tasks)
+{
+    result_t result = {0};
+    struct stat info;
+    sch_attr_t attr;
+    long add = 0;
+    long save = 0;
+    int fds[2];
+    pid_t child = 0;
+    size_t i = 0;
+
+    g_sch = SchCreate();
+
+    if (NULL == g_sch || 0 != pipe(fds))
+    {
+        return;
+    }
+
+    add = NowNs();
+
+    for (i = 0; i < tasks; ++i)
+    {
+        SchAttrInit(&attr, 1000 * (1 + i % 60));
+        attr.key = PROBE_KEY + 1 + i;
+        SchAddAttr(g_sch, &attr, Noop, NULL);
+    }
+
+    add = NowNs() - add;
+
+    /* the child expects the probe at its original deadline */
+    SchAttrInit(&attr, PROBE_MS);
+    attr.key = PROBE_KEY;
+    g_probe_due = NowNs() + PROBE_MS * 1000000L;
+    SchAddAttr(g_sch, &attr, Noop, NULL);
+
+    save = NowNs();
+
+    if (0 != SchSave(g_sch, SNAP_PATH) || 0 != stat(SNAP_PATH, &info))
+    {
+        SchDestroy(g_sch);
+
+        return;
+    }
+
+    save = NowNs() - save;
+    SchDestroy(g_sch);
+
+    child = fork();
+
+    if (0 == child)
+    {
+        Restore(fds[1]);
+    }
+
+    close(fds[1]);
+
+    if (0 < child && sizeof(result) == read(fds[0], &result, sizeof(result)))
+    {
+        printf("%10lu %10.1f %10.1f %10.1f %10.0f %10lu %12.1f\n",
+            (unsigned long)tasks, add / 1e6, save / 1e6, result.load_ms,
+            (double)info.st_size / 1024, (unsigned long)result.restored,
+            result.probe_us);
+    }
+
+    close(fds[0]);
+    waitpid(child, NULL, 0);
+}
+
+/* runs in the child, as a respawned process would */
+static void Restore(int fd)
+{
+    long load = NowNs();
+
+    g_sch = SchCreate();
+
+    if (NULL == g_sch || 0 != SchLoad(g_sch, SNAP_PATH, Bind, NULL))
+    {
+        _exit(1);
+    }
+
+    g_result.load_ms = (NowNs() - load) / 1e6;
+    g_result.restored = SchSize(g_sch);
+
+    SchRun(g_sch);
+    SchDestroy(g_sch);
+
+    if (sizeof(g_result) != write(fd, &g_result, sizeof(g_result)))
+    {
+        _exit(1);
+    }
+
+    _exit(0);
+}
+
+static int Bind(size_t key, opt_t *operation, void **arg, void *param)
+{
+    (void)param;
+
+    *operation = (PROBE_KEY == key) ? Probe : Noop;
+    *arg = NULL;
+
+    return 0;
+}
+
+static int Probe(void *arg)
+{
+    (void)arg;
+
+    g_result.probe_us = (NowNs() - g_probe_due) / 1e3;
+    SchStop(g_sch);
+
+    return 1;
+}
+
+static int Noop(void *arg)
+{
+    (void)arg;
+
+    return 0;
+}
+
+static long NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
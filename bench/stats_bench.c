@@ -0,0 +1,105 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <time.h>           /* clock_gettime    */
+
+#include "scheduler.h"
+
+#define TASKS (1000)
+#define RUNS (2000000)
+#define ROUNDS (5)
+#define EXPORT_PATH "/tmp/sch_stats_bench.txt"
+#define EXPORT_SHM "/sch_stats_bench"
+
+static size_t g_runs = 0;
+
+static int Noop(void *arg);
+static double NowNs(void);
+static double Run(sch_t *sch, int stats);
+
+int main(void)
+{
+    sch_t *sch = SchCreate();
+    sch_stats_t stats;
+    double off = 1e9;
+    double on = 1e9;
+    size_t round = 0;
+
+    if (NULL == sch)
+    {
+        return 1;
+    }
+
+    /* alternate, best of each, the machine's noise hits both */
+    for (round = 0; round < ROUNDS; ++round)
+    {
+        double ns = Run(sch, 0);
+
+        off = (ns < off) ? ns : off;
+        ns = Run(sch, 1);
+        on = (ns < on) ? ns : on;
+    }
+
+    printf("%d tasks, %d runs, interval 0, noop task, best of %d\n", TASKS,
+                                                            RUNS, ROUNDS);
+    printf("%-12s %12s\n", "stats", "ns/run");
+    printf("%-12s %12.1f\n", "off", off);
+    printf("%-12s %12.1f\n", "on", on);
+    printf("%-12s %12.1f\n", "cost", on - off);
+
+    if (0 == SchGetStats(sch, &stats))
+    {
+        printf("\nruns %lu, lateness p50 %lu ns p99 %lu ns, "
+                            "runtime p50 %lu ns p99 %lu ns, depth p50 %lu\n",
+                (unsigned long)stats.runs,
+                (unsigned long)HistPercentile(&stats.lateness, 50),
+                (unsigned long)HistPercentile(&stats.lateness, 99),
+                (unsigned long)HistPercentile(&stats.runtime, 50),
+                (unsigned long)HistPercentile(&stats.runtime, 99),
+                (unsigned long)HistPercentile(&stats.queue_depth, 50));
+
+        printf("export to %s: %s\n", EXPORT_PATH,
+                (0 == SchStatsExport(&stats, EXPORT_PATH)) ? "ok" : "failed");
+        printf("export to shm %s: %s\n", EXPORT_SHM,
+                (0 == SchStatsExportShm(&stats, EXPORT_SHM)) ? "ok" : "failed");
+    }
+
+    SchDestroy(sch);
+
+    return 0;
+}
+
+static double Run(sch_t *sch, int stats)
+{
+    double start = 0;
+    size_t i = 0;
+
+    for (i = 0; i < TASKS; ++i)
+    {
+        SchAdd(sch, 0, Noop, NULL);
+    }
+
+    SchSetStats(sch, stats);
+    g_runs = 0;
+    start = NowNs();
+    SchRun(sch);
+
+    return (NowNs() - start) / g_runs;
+}
+
+/* the last run stops the scheduler, all tasks are dropped */
+static int Noop(void *arg)
+{
+    (void)arg;
+
+    return (RUNS <= ++g_runs);
+}
+
+static double NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
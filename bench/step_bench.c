@@ -0,0 +1,230 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>          /* printf           */
+#include <time.h>           /* clock_gettime    */
+#include <poll.h>           /* poll             */
+#include <pthread.h>        /* pthread_create   */
+#include <unistd.h>         /* read, close      */
+#include <sys/timerfd.h>    /* timerfd_create   */
+#include <sys/resource.h>   /* getrusage        */
+
+#include "scheduler.h"
+
+#define MAX_IDLE (100000)
+#define STEPS (100000)
+#define EVENT_US (1000)
+#define HEARTBEATS (10)
+#define HEARTBEAT_MS (10)
+#define RUN_NS (2000000000L)
+#define RING (1024)
+
+/*
+    a host with its own poll loop: a timerfd fires every EVENT_US,
+    each event hands a one shot job to the scheduler, which also runs
+    HEARTBEATS periodic tasks. The scheduler either has a thread in
+    SchRun, or the host steps it inline with SchRunOnce.
+*/
+static sch_t *g_sch = NULL;
+static hist_t g_delay;
+static long g_added[RING];
+static volatile int g_done = 0;
+
+static void IdleStep(const char *name, int use_wheel, size_t tasks);
+static void Host(const char *name, int inline_run);
+static void *SchThread(void *arg);
+static int Job(void *arg);
+static int Heartbeat(void *arg);
+static int Stop(void *arg);
+static long Switches(void);
+static long NowNs(void);
+
+int main(void)
+{
+    size_t tasks = 0;
+
+    printf("SchRunOnce with nothing due\n");
+    printf("%-8s %10s %12s\n", "engine", "tasks", "ns/step");
+
+    for (tasks = 10; tasks <= MAX_IDLE; tasks *= 100)
+    {
+        IdleStep("heap", 0, tasks);
+        IdleStep("wheel", 1, tasks);
+    }
+
+    printf("\nhost loop, an event every %d us hands a job to the scheduler, "
+            "%d heartbeats every %d ms, %.1f s\n", EVENT_US, HEARTBEATS,
+            HEARTBEAT_MS, RUN_NS / 1e9);
+    printf("%-8s %10s %12s %12s %12s %12s\n", "driver", "jobs",
+                "p50 us", "p99 us", "switches", "per job");
+
+    Host("thread", 0);
+    Host("inline", 1);
+
+    return 0;
+}
+
+static void IdleStep(const char *name, int use_wheel, size_t tasks)
+{
+    long start = 0;
+    size_t i = 0;
+
+    g_sch = use_wheel ? SchCreateWheel() : SchCreate();
+
+    if (NULL == g_sch)
+    {
+        return;
+    }
+
+    for (i = 0; i < tasks; ++i)
+    {
+        SchAdd(g_sch, 60000 + i % 1000, Heartbeat, NULL);
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < STEPS; ++i)
+    {
+        SchRunOnce(g_sch);
+    }
+
+    printf("%-8s %10lu %12.1f\n", name, (unsigned long)tasks,
+                                    (double)(NowNs() - start) / STEPS);
+
+    SchDestroy(g_sch);
+}
+
+static void Host(const char *name, int inline_run)
+{
+    struct itimerspec spec = {{0}, {0}};
+    struct pollfd pfd;
+    pthread_t thread;
+    unsigned long ticks = 0;
+    size_t jobs = 0;
+    long switches = 0;
+    long end = 0;
+    size_t i = 0;
+
+    g_sch = SchCreate();
+    pfd.fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    pfd.events = POLLIN;
+
+    if (NULL == g_sch || -1 == pfd.fd)
+    {
+        return;
+    }
+
+    for (i = 0; i < HEARTBEATS; ++i)
+    {
+        SchAdd(g_sch, HEARTBEAT_MS, Heartbeat, NULL);
+    }
+
+    SchAdd(g_sch, RUN_NS / 1000000, Stop, NULL);
+
+    HistInit(&g_delay);
+    g_done = 0;
+    spec.it_interval.tv_nsec = EVENT_US * 1000L;
+    spec.it_value.tv_nsec = EVENT_US * 1000L;
+    timerfd_settime(pfd.fd, 0, &spec, NULL);
+
+    if (!inline_run && 0 != pthread_create(&thread, NULL, SchThread, NULL))
+    {
+        return;
+    }
+
+    switches = Switches();
+    end = NowNs() + RUN_NS;
+
+    while (!g_done && NowNs() < end)
+    {
+        int timeout = -1;
+
+        if (inline_run)
+        {
+            size_t wait_ms = SchRunOnce(g_sch);
+
+            timeout = (SCH_NO_DEADLINE == wait_ms) ? -1 : (int)wait_ms;
+        }
+
+        if (0 < poll(&pfd, 1, timeout) &&
+                    sizeof(ticks) == read(pfd.fd, &ticks, sizeof(ticks)))
+        {
+            long *added = &g_added[jobs % RING];
+
+            *added = NowNs();
+            SchAdd(g_sch, 0, Job, added);
+            ++jobs;
+        }
+    }
+
+    switches = Switches() - switches;
+
+    SchStop(g_sch);
+
+    if (!inline_run)
+    {
+        pthread_join(thread, NULL);
+    }
+
+    printf("%-8s %10lu %12.1f %12.1f %12ld %12.2f\n", name,
+        (unsigned long)jobs, HistPercentile(&g_delay, 50) / 1e3,
+        HistPercentile(&g_delay, 99) / 1e3, switches,
+        (double)switches / (jobs ? jobs : 1));
+
+    close(pfd.fd);
+    SchDestroy(g_sch);
+}
+
+static void *SchThread(void *arg)
+{
+    (void)arg;
+
+    SchRun(g_sch);
+
+    return NULL;
+}
+
+/* one shot, from the host handing it over to the run */
+static int Job(void *arg)
+{
+    long now = NowNs();
+    long added = *(long *)arg;
+
+    HistRecord(&g_delay, (now > added) ? now - added : 0);
+
+    return 1;
+}
+
+static int Heartbeat(void *arg)
+{
+    (void)arg;
+
+    return 0;
+}
+
+static int Stop(void *arg)
+{
+    (void)arg;
+
+    g_done = 1;
+
+    return 1;
+}
+
+/* voluntary and involuntary, of every thread in the process */
+static long Switches(void)
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+static long NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
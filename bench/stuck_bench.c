@@ -0,0 +1,117 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <time.h>           /* nanosleep        */
+
+#include "scheduler.h"
+
+#define BEAT_MS (10)
+#define BEATS (100)
+#define STUCK_INTERVAL_MS (200)
+#define STUCK_MS (500)
+#define MAX_RUNTIME_MS (50)
+
+static sch_t *g_sch = NULL;
+static long g_last_ns = 0;
+static long g_max_gap_ns = 0;
+static size_t g_beats = 0;
+static int g_stuck = 0;
+
+static int Beat(void *arg);
+static int Stuck(void *arg);
+static long NowNs(void);
+static void Run(const char *name, int use_wheel, int spare);
+
+int main(void)
+{
+    printf("heartbeat every %d ms, another task blocks %d ms once "
+                    "(max runtime %d ms)\n", BEAT_MS, STUCK_MS, MAX_RUNTIME_MS);
+    printf("%-8s %-8s %10s %14s\n", "engine", "spare", "overruns",
+                                                        "max gap ms");
+
+    Run("heap", 0, 0);
+    Run("heap", 0, 1);
+    Run("wheel", 1, 0);
+    Run("wheel", 1, 1);
+
+    return 0;
+}
+
+static void Run(const char *name, int use_wheel, int spare)
+{
+    sch_attr_t attr = {0};
+
+    g_sch = use_wheel ? SchCreateWheel() : SchCreate();
+
+    if (NULL == g_sch)
+    {
+        return;
+    }
+
+    g_last_ns = 0;
+    g_max_gap_ns = 0;
+    g_beats = 0;
+    g_stuck = 0;
+
+    SchSetSpare(g_sch, spare);
+    SchAttrInit(&attr, STUCK_INTERVAL_MS);
+    attr.max_runtime = MAX_RUNTIME_MS;
+    SchAddAttr(g_sch, &attr, Stuck, NULL);
+    SchAdd(g_sch, BEAT_MS, Beat, NULL);
+    SchRun(g_sch);
+
+    printf("%-8s %-8s %10lu %14.1f\n", name, spare ? "on" : "off",
+                (unsigned long)SchOverruns(g_sch), g_max_gap_ns / 1e6);
+
+    SchDestroy(g_sch);
+}
+
+static int Beat(void *arg)
+{
+    long now = NowNs();
+
+    (void)arg;
+
+    if (0 != g_last_ns && now - g_last_ns > g_max_gap_ns)
+    {
+        g_max_gap_ns = now - g_last_ns;
+    }
+
+    g_last_ns = now;
+
+    if (BEATS <= ++g_beats)
+    {
+        SchStop(g_sch);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+/* blocks on its first run, like a task waiting on a semaphore */
+static int Stuck(void *arg)
+{
+    (void)arg;
+
+    if (!g_stuck)
+    {
+        struct timespec stuck = {0};
+
+        stuck.tv_sec = STUCK_MS / 1000;
+        stuck.tv_nsec = (STUCK_MS % 1000) * 1000000L;
+        g_stuck = 1;
+        nanosleep(&stuck, NULL);
+    }
+
+    return 0;
+}
+
+static long NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
@@ -0,0 +1,156 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <time.h>           /* clock_gettime    */
+#include <pthread.h>        /* pthread_create   */
+#include <semaphore.h>      /* sem_t            */
+
+#include "scheduler.h"
+
+#define MAX_PRODUCERS (64)
+#define TASKS (256000)
+#define KEEP_ALIVE_MS (3600000)
+
+typedef struct
+{
+    double add_ns;
+} producer_t;
+
+static sch_t *g_sch = NULL;
+static sem_t g_start;
+static size_t g_tasks = 0;
+static size_t g_done = 0;
+
+static void Run(const char *name, int use_lock, size_t producers);
+static void *Produce(void *arg);
+static int Start(void *arg);
+static int Count(void *arg);
+static int KeepAlive(void *arg);
+static double NowNs(void);
+
+int main(void)
+{
+    size_t producers = 0;
+
+    printf("%d one shot tasks added from n threads while SchRun sleeps\n",
+                                                                    TASKS);
+    printf("%-8s %10s %12s %14s\n", "queue", "producers", "add ns/op",
+                                                            "tasks/s (M)");
+
+    for (producers = 1; producers <= MAX_PRODUCERS; producers *= 2)
+    {
+        Run("mpsc", 0, producers);
+        Run("mutex", 1, producers);
+    }
+
+    return 0;
+}
+
+/* mutex is the locked SchAdd of a one worker SchCreateParallel */
+static void Run(const char *name, int use_lock, size_t producers)
+{
+    pthread_t threads[MAX_PRODUCERS];
+    producer_t stats[MAX_PRODUCERS];
+    double start = 0;
+    double total = 0;
+    double add = 0;
+    size_t i = 0;
+
+    g_sch = use_lock ? SchCreateParallel(1) : SchCreate();
+
+    if (NULL == g_sch || 0 != sem_init(&g_start, 0, 0))
+    {
+        return;
+    }
+
+    g_tasks = TASKS / producers * producers;
+    g_done = 0;
+
+    SchAdd(g_sch, KEEP_ALIVE_MS, KeepAlive, NULL);
+    SchAdd(g_sch, 0, Start, (void *)producers);
+
+    for (i = 0; i < producers; ++i)
+    {
+        stats[i].add_ns = (double)(TASKS / producers);
+        pthread_create(&threads[i], NULL, Produce, &stats[i]);
+    }
+
+    start = NowNs();
+    SchRun(g_sch);
+    total = NowNs() - start;
+
+    for (i = 0; i < producers; ++i)
+    {
+        pthread_join(threads[i], NULL);
+        add += stats[i].add_ns;
+    }
+
+    printf("%-8s %10lu %12.1f %14.2f\n", name, (unsigned long)producers,
+                        add / g_tasks, g_tasks / total * 1e3);
+
+    sem_destroy(&g_start);
+    SchDestroy(g_sch);
+}
+
+/* stats holds the number of adds on the way in, their cost on the way out */
+static void *Produce(void *arg)
+{
+    producer_t *stats = (producer_t *)arg;
+    size_t count = (size_t)stats->add_ns;
+    double start = 0;
+    size_t i = 0;
+
+    sem_wait(&g_start);
+    start = NowNs();
+
+    for (i = 0; i < count; ++i)
+    {
+        SchAdd(g_sch, 0, Count, NULL);
+    }
+
+    stats->add_ns = NowNs() - start;
+
+    return NULL;
+}
+
+/* producers start only once SchRun owns the scheduler */
+static int Start(void *arg)
+{
+    size_t producers = (size_t)arg;
+
+    while (0 < producers)
+    {
+        sem_post(&g_start);
+        --producers;
+    }
+
+    return 1;
+}
+
+static int Count(void *arg)
+{
+    (void)arg;
+
+    if (g_tasks == __sync_add_and_fetch(&g_done, 1))
+    {
+        SchStop(g_sch);
+    }
+
+    return 1;
+}
+
+static int KeepAlive(void *arg)
+{
+    (void)arg;
+
+    return 0;
+}
+
+static double NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
@@ -0,0 +1,571 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* malloc, strtoul  */
+#include <string.h>         /* strcmp           */
+#include <time.h>           /* clock_gettime    */
+#include <unistd.h>         /* fork, pipe       */
+#include <sys/wait.h>       /* waitpid          */
+
+#include "scheduler.h"
+#include "priority_q.h"
+#include "sorted_ll.h"
+#include "dllist.h"
+
+#define MIN_N (100)
+#define MAX_N (1000000)
+#define RUN_OPS (1000000)
+#define RESCHED_OPS (100000)
+#define LIST_BUDGET (20000000)
+#define LIST_MIN_OPS (20)
+#define MAX_INTERVAL (3600000)
+#define JITTER_PERIODS (3)
+
+/*
+    usage: suite_bench.out [csv|json] [max n]
+    every record is one measurement:
+        group - sch, pq, sortedlist or dl
+        case - what was measured, engine or backend first
+        n - elements in the structure
+        value, unit - ns/op, bytes/task or ns of lateness
+    record names stay fixed between releases, so results can be diffed.
+*/
+
+typedef struct
+{
+    size_t key;
+} item_t;
+
+static int g_json = 0;
+static int g_first = 1;
+static sch_t *g_sch = NULL;
+static size_t g_runs = 0;
+static size_t g_target = 0;
+
+static void Emit(const char *group, const char *name, size_t n, double value,
+                                                        const char *unit);
+static void RunSch(const char *engine, int use_wheel, size_t n,
+                                            ilrd_uid_t *uids);
+static void RunSchMemory(const char *engine, int use_wheel, size_t n);
+static void RunSchJitter(const char *engine, int use_wheel, size_t n);
+static void RunPQ(const char *backend, pq_t *pq, item_t *items, size_t n);
+static void RunSortedList(item_t *items, size_t n);
+static void RunDL(item_t *items, size_t n);
+static size_t ListOps(size_t n);
+static int Tick(void *arg);
+static int Noop(void *arg);
+static int Stop(void *arg);
+static int PQBefore(const void *data, const void *to_compare);
+static int ListBefore(const void *data, const void *to_compare);
+static int ListMatch(const void *data, const void *to_cmp, void *arg);
+static int DLMatch(const void *data, const void *to_compare);
+static double NowNs(void);
+static size_t Rand(void);
+static size_t RssBytes(void);
+
+int main(int argc, char *argv[])
+{
+    size_t max_n = MAX_N;
+    item_t *items = NULL;
+    ilrd_uid_t *uids = NULL;
+    size_t n = 0;
+
+    if (1 < argc)
+    {
+        g_json = (0 == strcmp(argv[1], "json"));
+    }
+
+    if (2 < argc)
+    {
+        max_n = strtoul(argv[2], NULL, 10);
+    }
+
+    items = (item_t *)malloc(max_n * sizeof(item_t));
+    uids = (ilrd_uid_t *)malloc(max_n * sizeof(ilrd_uid_t));
+
+    if (NULL == items || NULL == uids)
+    {
+        free(items);
+        free(uids);
+
+        return 1;
+    }
+
+    printf(g_json ? "[\n" : "group,case,n,value,unit\n");
+
+    for (n = MIN_N; n <= max_n; n *= 10)
+    {
+        RunSch("heap", 0, n, uids);
+        RunSch("wheel", 1, n, uids);
+        RunSchMemory("heap", 0, n);
+        RunSchMemory("wheel", 1, n);
+        RunSchJitter("heap", 0, n);
+        RunSchJitter("wheel", 1, n);
+        RunPQ("list", PriorityQCreate(PQBefore), items, n);
+        RunPQ("heap", PriorityQCreateHeap(PQBefore, 0), items, n);
+        RunSortedList(items, n);
+        RunDL(items, n);
+    }
+
+    printf(g_json ? "\n]\n" : "");
+
+    free(items);
+    free(uids);
+
+    return 0;
+}
+
+static void Emit(const char *group, const char *name, size_t n, double value,
+                                                        const char *unit)
+{
+    if (g_json)
+    {
+        printf("%s  {\"group\": \"%s\", \"case\": \"%s\", \"n\": %lu, "
+                "\"value\": %.1f, \"unit\": \"%s\"}", g_first ? "" : ",\n",
+                group, name, (unsigned long)n, value, unit);
+    }
+    else
+    {
+        printf("%s,%s,%lu,%.1f,%s\n", group, name, (unsigned long)n, value,
+                                                                    unit);
+    }
+
+    g_first = 0;
+    fflush(stdout);
+}
+
+/*
+    add: n tasks with random intervals
+    reschedule: remove one task and add it back, n in the scheduler
+    run: interval 0 tasks, one run is a pop, a call and a push
+    remove: all n, in random order
+*/
+static void RunSch(const char *engine, int use_wheel, size_t n,
+                                            ilrd_uid_t *uids)
+{
+    char name[32];
+    double start = 0;
+    size_t i = 0;
+
+    g_sch = use_wheel ? SchCreateWheel() : SchCreate();
+
+    if (NULL == g_sch)
+    {
+        return;
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < n; ++i)
+    {
+        uids[i] = SchAdd(g_sch, 1 + Rand() % MAX_INTERVAL, Noop, NULL);
+    }
+
+    sprintf(name, "%s_add", engine);
+    Emit("sch", name, n, (NowNs() - start) / n, "ns/op");
+
+    start = NowNs();
+
+    for (i = 0; i < RESCHED_OPS; ++i)
+    {
+        size_t at = Rand() % n;
+
+        SchRemove(g_sch, uids[at]);
+        uids[at] = SchAdd(g_sch, 1 + Rand() % MAX_INTERVAL, Noop, NULL);
+    }
+
+    sprintf(name, "%s_reschedule", engine);
+    Emit("sch", name, n, (NowNs() - start) / RESCHED_OPS, "ns/op");
+
+    for (i = n; 1 < i; --i)
+    {
+        size_t at = Rand() % i;
+        ilrd_uid_t uid = uids[at];
+
+        uids[at] = uids[i - 1];
+        uids[i - 1] = uid;
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < n; ++i)
+    {
+        SchRemove(g_sch, uids[i]);
+    }
+
+    sprintf(name, "%s_remove", engine);
+    Emit("sch", name, n, (NowNs() - start) / n, "ns/op");
+
+    for (i = 0; i < n; ++i)
+    {
+        SchAdd(g_sch, 0, Tick, NULL);
+    }
+
+    g_runs = 0;
+    g_target = (n < RUN_OPS) ? RUN_OPS : n;
+    start = NowNs();
+    SchRun(g_sch);
+
+    sprintf(name, "%s_run", engine);
+    Emit("sch", name, n, (NowNs() - start) / g_runs, "ns/op");
+
+    SchDestroy(g_sch);
+}
+
+/* one child per run, so RSS is not polluted by earlier runs */
+static void RunSchMemory(const char *engine, int use_wheel, size_t n)
+{
+    char name[32];
+    double bytes = 0;
+    int fds[2];
+    pid_t child = 0;
+
+    if (0 != pipe(fds))
+    {
+        return;
+    }
+
+    child = fork();
+
+    if (0 == child)
+    {
+        sch_t *sch = use_wheel ? SchCreateWheel() : SchCreate();
+        size_t rss = RssBytes();
+        size_t i = 0;
+
+        for (i = 0; NULL != sch && i < n; ++i)
+        {
+            SchAdd(sch, 1 + Rand() % MAX_INTERVAL, Noop, NULL);
+        }
+
+        bytes = (double)(RssBytes() - rss) / n;
+
+        if (sizeof(bytes) != write(fds[1], &bytes, sizeof(bytes)))
+        {
+            _exit(1);
+        }
+
+        _exit(0);
+    }
+
+    close(fds[1]);
+
+    if (0 < child && sizeof(bytes) == read(fds[0], &bytes, sizeof(bytes)))
+    {
+        sprintf(name, "%s_memory", engine);
+        Emit("sch", name, n, bytes, "bytes/task");
+    }
+
+    close(fds[0]);
+    waitpid(child, NULL, 0);
+}
+
+/* intervals grow with n so the loop is never overloaded */
+static void RunSchJitter(const char *engine, int use_wheel, size_t n)
+{
+    static sch_stats_t stats;
+    char name[32];
+    size_t interval = (10000 < n) ? n / 1000 : 10;
+    sch_attr_t attr;
+    size_t i = 0;
+
+    g_sch = use_wheel ? SchCreateWheel() : SchCreate();
+
+    if (NULL == g_sch)
+    {
+        return;
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        SchAdd(g_sch, interval, Noop, NULL);
+    }
+
+    SchAttrInit(&attr, interval * JITTER_PERIODS);
+    attr.lane = SCH_LANE_CRITICAL;
+    SchAddAttr(g_sch, &attr, Stop, NULL);
+
+    SchSetStats(g_sch, 1);
+    SchRun(g_sch);
+
+    if (0 == SchGetStats(g_sch, &stats))
+    {
+        sprintf(name, "%s_jitter_p50", engine);
+        Emit("sch", name, n, (double)HistPercentile(&stats.lateness, 50), "ns");
+        sprintf(name, "%s_jitter_p99", engine);
+        Emit("sch", name, n, (double)HistPercentile(&stats.lateness, 99), "ns");
+        sprintf(name, "%s_jitter_max", engine);
+        Emit("sch", name, n, (double)stats.lateness.max, "ns");
+    }
+
+    SchDestroy(g_sch);
+}
+
+/*
+    enqueue: n items in deadline order
+    reschedule: peek, dequeue, push the deadline forward, enqueue
+    dequeue: all n
+    the list backend is O(n) per enqueue, it is built in the order
+    that keeps the walk short and reschedules on a budget of operations
+*/
+static void RunPQ(const char *backend, pq_t *pq, item_t *items, size_t n)
+{
+    char name[32];
+    int is_list = (0 == strcmp(backend, "list"));
+    size_t ops = is_list ? ListOps(n) : RESCHED_OPS;
+    double start = 0;
+    size_t i = 0;
+
+    if (NULL == pq)
+    {
+        return;
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < n; ++i)
+    {
+        items[i].key = i;
+        PriorityQEnqueue(pq, &items[i]);
+    }
+
+    sprintf(name, "%s_enqueue", backend);
+    Emit("pq", name, n, (NowNs() - start) / n, "ns/op");
+
+    start = NowNs();
+
+    for (i = 0; i < ops; ++i)
+    {
+        item_t *item = PriorityQPeek(pq);
+
+        PriorityQDequeue(pq);
+        item->key += 1 + Rand() % n;
+        PriorityQEnqueue(pq, item);
+    }
+
+    sprintf(name, "%s_reschedule", backend);
+    Emit("pq", name, n, (NowNs() - start) / ops, "ns/op");
+
+    start = NowNs();
+
+    while (!PriorityQIsEmpty(pq))
+    {
+        PriorityQDequeue(pq);
+    }
+
+    sprintf(name, "%s_dequeue", backend);
+    Emit("pq", name, n, (NowNs() - start) / n, "ns/op");
+
+    PriorityQDestroy(pq);
+}
+
+/*
+    insert: a random key into a list of n, then erased again
+    find: a random key
+    pop_front: all n
+*/
+static void RunSortedList(item_t *items, size_t n)
+{
+    sortedlist_t *list = SortedListCreate(ListBefore);
+    size_t ops = ListOps(n);
+    item_t probe = {0};
+    double start = 0;
+    size_t i = 0;
+
+    if (NULL == list)
+    {
+        return;
+    }
+
+    /* each key lands at the front, the build stays O(n) */
+    for (i = 0; i < n; ++i)
+    {
+        items[i].key = 2 * (n - i);
+        SortedListInsert(list, &items[i]);
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < ops; ++i)
+    {
+        probe.key = 1 + 2 * (Rand() % n);
+        SortedListErase(SortedListInsert(list, &probe));
+    }
+
+    Emit("sortedlist", "insert", n, (NowNs() - start) / ops, "ns/op");
+
+    start = NowNs();
+
+    for (i = 0; i < ops; ++i)
+    {
+        probe.key = 2 * (1 + Rand() % n);
+        SortedListFind(SortedListBegin(list), SortedListEnd(list), ListMatch,
+                                                            &probe, NULL);
+    }
+
+    Emit("sortedlist", "find", n, (NowNs() - start) / ops, "ns/op");
+
+    start = NowNs();
+
+    while (!SortedListIsEmpty(list))
+    {
+        SortedListPopFront(list);
+    }
+
+    Emit("sortedlist", "pop_front", n, (NowNs() - start) / n, "ns/op");
+
+    SortedListDestroy(list);
+}
+
+/*
+    push_back: n items
+    find: a random item
+    pop_front: all n
+*/
+static void RunDL(item_t *items, size_t n)
+{
+    dlist_t *list = DLCreate();
+    size_t ops = ListOps(n);
+    item_t probe = {0};
+    double start = 0;
+    size_t i = 0;
+
+    if (NULL == list)
+    {
+        return;
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < n; ++i)
+    {
+        items[i].key = i;
+        DLPushBack(list, &items[i]);
+    }
+
+    Emit("dl", "push_back", n, (NowNs() - start) / n, "ns/op");
+
+    start = NowNs();
+
+    for (i = 0; i < ops; ++i)
+    {
+        probe.key = Rand() % n;
+        DLFind(DLBegin(list), DLEnd(list), DLMatch, &probe);
+    }
+
+    Emit("dl", "find", n, (NowNs() - start) / ops, "ns/op");
+
+    start = NowNs();
+
+    while (!DLIsEmpty(list))
+    {
+        DLPopFront(list);
+    }
+
+    Emit("dl", "pop_front", n, (NowNs() - start) / n, "ns/op");
+
+    DLDestroy(list);
+}
+
+/* O(n) operations get a fixed budget of element visits */
+static size_t ListOps(size_t n)
+{
+    return (LIST_BUDGET / n < LIST_MIN_OPS) ? LIST_MIN_OPS : LIST_BUDGET / n;
+}
+
+static int Tick(void *arg)
+{
+    (void)arg;
+
+    if (++g_runs >= g_target)
+    {
+        SchStop(g_sch);
+    }
+
+    return 0;
+}
+
+static int Noop(void *arg)
+{
+    (void)arg;
+
+    return 0;
+}
+
+static int Stop(void *arg)
+{
+    (void)arg;
+
+    SchStop(g_sch);
+
+    return 1;
+}
+
+static int PQBefore(const void *data, const void *to_compare)
+{
+    const item_t *item = data;
+    const item_t *item_to_compare = to_compare;
+
+    return ((item->key < item_to_compare->key) ? 0 : 1);
+}
+
+static int ListBefore(const void *data, const void *to_compare)
+{
+    const item_t *item = data;
+    const item_t *item_to_compare = to_compare;
+
+    return (item->key < item_to_compare->key);
+}
+
+static int ListMatch(const void *data, const void *to_cmp, void *arg)
+{
+    (void)arg;
+
+    return (((const item_t *)data)->key == ((const item_t *)to_cmp)->key);
+}
+
+static int DLMatch(const void *data, const void *to_compare)
+{
+    return (((const item_t *)data)->key == ((const item_t *)to_compare)->key);
+}
+
+static double NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+static size_t Rand(void)
+{
+    static unsigned long state = 88172645463325252UL;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return (size_t)state;
+}
+
+static size_t RssBytes(void)
+{
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+
+    if (NULL == statm)
+    {
+        return 0;
+    }
+
+    if (2 != fscanf(statm, "%lu %lu", &size, &resident))
+    {
+        resident = 0;
+    }
+
+    fclose(statm);
+
+    return resident * sysconf(_SC_PAGESIZE);
+}
@@ -0,0 +1,255 @@
+#define _POSIX_C_SOURCE (200112L)
+
+#include <stdio.h>          /* printf           */
+#include <stdlib.h>         /* malloc           */
+#include <time.h>           /* clock_gettime    */
+#include <unistd.h>         /* fork, sysconf    */
+#include <sys/wait.h>       /* waitpid          */
+
+#include "scheduler.h"
+#include "priority_q.h"
+#include "timing_wheel.h"
+
+#define MIN_TASKS (10000)
+#define MAX_TASKS (1000000)
+#define MAX_TIMERS (6400000)
+#define MAX_INTERVAL (3600)
+#define SPAN_TICKS (60000)
+#define REMOVE_BUDGET (100000000)
+#define MIN_REMOVES (100)
+
+typedef struct
+{
+    size_t key;
+    twnode_t node;
+} item_t;
+
+static int Noop(void *arg);
+static int IsBefore(const void *data, const void *to_compare);
+static double NowNs(void);
+static size_t Rand(void);
+static size_t RssBytes(void);
+static void RunSch(const char *name, int use_wheel, size_t n);
+static void RunExpiry(size_t n);
+
+int main(void)
+{
+    size_t n = 0;
+
+    printf("scheduler API (SchAdd / SchRemove / memory)\n");
+    printf("%-8s %10s %12s %12s %14s\n", "engine", "tasks", "add ns/op",
+                                            "remove ns/op", "bytes/task");
+
+    for (n = MIN_TASKS; n <= MAX_TASKS; n *= 10)
+    {
+        RunSch("heap", 0, n);
+        RunSch("wheel", 1, n);
+    }
+
+    printf("\nexpiry throughput (arm n timers over %d ticks, expire all)\n",
+                                                                SPAN_TICKS);
+    printf("%-8s %10s %12s %12s\n", "engine", "timers", "arm ns/op",
+                                                            "expire ns/op");
+
+    for (n = MIN_TASKS * 10; n <= MAX_TIMERS; n *= 4)
+    {
+        RunExpiry(n);
+    }
+
+    return 0;
+}
+
+/* one child per run, so RSS is not polluted by earlier runs */
+static void RunSch(const char *name, int use_wheel, size_t n)
+{
+    pid_t child = 0;
+
+    fflush(stdout);
+    child = fork();
+
+    if (0 == child)
+    {
+        ilrd_uid_t *uids = (ilrd_uid_t *)malloc(n * sizeof(ilrd_uid_t));
+        size_t rss = RssBytes();
+        size_t removes = REMOVE_BUDGET / n;
+        sch_t *sch = use_wheel ? SchCreateWheel() : SchCreate();
+        double start = 0;
+        double add = 0;
+        double remove = 0;
+        size_t i = 0;
+
+        if (NULL == uids || NULL == sch)
+        {
+            exit(1);
+        }
+
+        start = NowNs();
+
+        for (i = 0; i < n; ++i)
+        {
+            uids[i] = SchAdd(sch, 1 + Rand() % MAX_INTERVAL, Noop, NULL);
+        }
+
+        add = NowNs() - start;
+        rss = RssBytes() - rss - n * sizeof(ilrd_uid_t);
+
+        /* the heap engine erases in O(n), keep its run time bounded */
+        if (use_wheel || removes > n)
+        {
+            removes = n;
+        }
+
+        if (removes < MIN_REMOVES)
+        {
+            removes = MIN_REMOVES;
+        }
+
+        start = NowNs();
+
+        for (i = 0; i < removes; ++i)
+        {
+            SchRemove(sch, uids[(i * 7919) % n]);
+        }
+
+        remove = NowNs() - start;
+
+        printf("%-8s %10lu %12.1f %12.1f %14.1f\n", name, (unsigned long)n,
+                        add / n, remove / removes, (double)rss / n);
+        fflush(stdout);
+
+        SchDestroy(sch);
+        free(uids);
+        exit(0);
+    }
+
+    waitpid(child, NULL, 0);
+}
+
+static void RunExpiry(size_t n)
+{
+    item_t *timers = (item_t *)malloc(n * sizeof(item_t));
+    pq_t *pq = PriorityQCreateHeap(IsBefore, 0);
+    twheel_t *wheel = TWheelCreate(0);
+    double start = 0;
+    double arm = 0;
+    double expire = 0;
+    size_t tick = 0;
+    size_t i = 0;
+
+    if (NULL == timers || NULL == pq || NULL == wheel)
+    {
+        return;
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        timers[i].key = Rand() % SPAN_TICKS;
+    }
+
+    start = NowNs();
+
+    for (i = 0; i < n; ++i)
+    {
+        PriorityQEnqueue(pq, &timers[i]);
+    }
+
+    arm = NowNs() - start;
+    start = NowNs();
+
+    for (tick = 0; tick < SPAN_TICKS; ++tick)
+    {
+        while (!PriorityQIsEmpty(pq) &&
+                        ((item_t *)PriorityQPeek(pq))->key <= tick)
+        {
+            PriorityQDequeue(pq);
+        }
+    }
+
+    expire = NowNs() - start;
+
+    printf("%-8s %10lu %12.1f %12.1f\n", "heap", (unsigned long)n,
+                                                    arm / n, expire / n);
+
+    start = NowNs();
+
+    for (i = 0; i < n; ++i)
+    {
+        TWheelAdd(wheel, &timers[i].node, timers[i].key);
+    }
+
+    arm = NowNs() - start;
+    start = NowNs();
+
+    for (tick = 0; tick < SPAN_TICKS; ++tick)
+    {
+        while (NULL != TWheelExpire(wheel, tick))
+        {
+        }
+    }
+
+    expire = NowNs() - start;
+
+    printf("%-8s %10lu %12.1f %12.1f\n", "wheel", (unsigned long)n,
+                                                    arm / n, expire / n);
+    fflush(stdout);
+
+    TWheelDestroy(wheel);
+    PriorityQDestroy(pq);
+    free(timers);
+}
+
+static int Noop(void *arg)
+{
+    (void)arg;
+
+    return 0;
+}
+
+static int IsBefore(const void *data, const void *to_compare)
+{
+    const item_t *timer = data;
+    const item_t *timer_to_compare = to_compare;
+
+    return ((timer->key < timer_to_compare->key) ? 0 : 1);
+}
+
+static double NowNs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+static size_t Rand(void)
+{
+    static unsigned long state = 88172645463325252UL;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return (size_t)state;
+}
+
+static size_t RssBytes(void)
+{
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+
+    if (NULL == statm)
+    {
+        return 0;
+    }
+
+    if (2 != fscanf(statm, "%lu %lu", &size, &resident))
+    {
+        resident = 0;
+    }
+
+    fclose(statm);
+
+    return resident * sysconf(_SC_PAGESIZE);
+}
@@ -0,0 +1,202 @@
+/*==============================================================================
+Data Structures - Slab Arena and Object Pools
+Source
+OL66
+Version 1
+==============================================================================*/
+
+#include <stddef.h> /* size_t */
+#include <assert.h> /* assert */
+#include <stdlib.h> /* malloc */
+
+#include "arena.h"
+
+#define DEFAULT_SLAB_SIZE ((size_t)64 * 1024)
+#define ALIGNMENT (sizeof(slab_t))
+#define ALIGN(x) (((x) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT)
+#define PAYLOAD(arena) (((arena)->slab_size - sizeof(slab_t)) / ALIGNMENT * \
+																	ALIGNMENT)
+
+/* the header is padded so whatever follows it is aligned for any type */
+typedef union slab_u
+{
+	union slab_u *next;
+	long double align_ld;
+	void *align_ptr;
+	long align_l;
+} slab_t;
+
+struct arena_s
+{
+	slab_t *slabs;
+	char *next;
+	size_t left;
+	size_t slab_size;
+	size_t slab_count;
+};
+
+struct pool_s
+{
+	arena_t *arena;
+	void *free_list;
+	size_t elem_size;
+};
+
+static slab_t *NewSlab(arena_t *arena, size_t size);
+
+static void *Take(arena_t *arena, size_t size, size_t align);
+
+arena_t *ArenaCreate(size_t slab_size)
+{
+	arena_t *arena = (arena_t *)malloc(sizeof(arena_t));
+
+	if (NULL == arena)
+	{
+		return NULL;
+	}
+
+	arena->slabs = NULL;
+	arena->next = NULL;
+	arena->left = 0;
+	arena->slab_size = (sizeof(slab_t) >= slab_size) ? DEFAULT_SLAB_SIZE :
+																	slab_size;
+	arena->slab_count = 0;
+
+	return arena;
+}
+
+void ArenaDestroy(arena_t *arena)
+{
+	assert(arena);
+
+	while (NULL != arena->slabs)
+	{
+		slab_t *slab = arena->slabs;
+
+		arena->slabs = slab->next;
+		free(slab);
+	}
+
+	free(arena);
+	arena = NULL;
+}
+
+void *ArenaAlloc(arena_t *arena, size_t size)
+{
+	assert(arena);
+
+	return Take(arena, ALIGN(size), ALIGNMENT);
+}
+
+size_t ArenaSlabCount(const arena_t *arena)
+{
+	assert(arena);
+
+	return arena->slab_count;
+}
+
+pool_t *PoolCreate(arena_t *arena, size_t elem_size)
+{
+	pool_t *pool = NULL;
+
+	assert(arena);
+	assert(0 < elem_size);
+
+	pool = (pool_t *)ArenaAlloc(arena, sizeof(pool_t));
+
+	if (NULL == pool)
+	{
+		return NULL;
+	}
+
+	pool->arena = arena;
+	pool->free_list = NULL;
+
+	/* a free element holds the free list link, so pointer aligned
+	   is enough - elements pack tighter than malloc chunks */
+	pool->elem_size = (elem_size + sizeof(void *) - 1) / sizeof(void *) *
+															sizeof(void *);
+
+	return pool;
+}
+
+void *PoolAlloc(pool_t *pool)
+{
+	void *elem = NULL;
+
+	assert(pool);
+
+	if (NULL == pool->free_list)
+	{
+		return Take(pool->arena, pool->elem_size, sizeof(void *));
+	}
+
+	elem = pool->free_list;
+	pool->free_list = *(void **)elem;
+
+	return elem;
+}
+
+void PoolFree(pool_t *pool, void *elem)
+{
+	assert(pool);
+	assert(elem);
+
+	*(void **)elem = pool->free_list;
+	pool->free_list = elem;
+}
+
+/****************************************************************
+HELPER FUNCTION
+***************************************************************/
+static void *Take(arena_t *arena, size_t size, size_t align)
+{
+	void *block = NULL;
+	size_t pad = (align - (size_t)arena->next % align) % align;
+
+	if (size + pad > arena->left)
+	{
+		slab_t *slab = NULL;
+
+		/* big blocks get their own slab, the current one stays open */
+		if (size > PAYLOAD(arena))
+		{
+			slab = NewSlab(arena, size + sizeof(slab_t));
+
+			return (NULL == slab) ? NULL : slab + 1;
+		}
+
+		slab = NewSlab(arena, arena->slab_size);
+
+		if (NULL == slab)
+		{
+			return NULL;
+		}
+
+		arena->next = (char *)(slab + 1);
+		arena->left = PAYLOAD(arena);
+		pad = 0;
+	}
+
+	block = arena->next + pad;
+	arena->next += size + pad;
+	arena->left -= size + pad;
+
+	return block;
+}
+
+static slab_t *NewSlab(arena_t *arena, size_t size)
+{
+	slab_t *slab = (slab_t *)malloc(size);
+
+	if (NULL == slab)
+	{
+		return NULL;
+	}
+
+	slab->next = arena->slabs;
+	arena->slabs = slab;
+	++arena->slab_count;
+
+	return slab;
+}
@@ -0,0 +1,122 @@
+/*==============================================================================
+Data Structures - Slab Arena and Object Pools
+Header
+OL66
+Version 1
+==============================================================================*/
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h> /* size_t */
+
+typedef struct arena_s arena_t;
+/*
+struct arena_s
+{
+	slab_t *slabs;
+	char *next;
+	size_t left;
+	size_t slab_size;
+	size_t slab_count;
+};
+*/
+
+typedef struct pool_s pool_t;
+/*
+struct pool_s
+{
+	arena_t *arena;
+	void *free_list;
+	size_t elem_size;
+};
+*/
+
+/*
+	Creates a new arena, memory is taken from the system in fixed
+	size slabs and only returned when the arena is destroyed.
+	Not thread safe.
+
+	Arguments:
+		slab_size - bytes per slab, 0 selects the default (64 KiB).
+
+	returns arena pointer, NULL on failure.
+
+	complexity O(1)
+*/
+arena_t *ArenaCreate(size_t slab_size);
+
+/*
+	Destroy a given arena, frees every slab at once.
+	All pools and memory taken from it become invalid.
+
+	arguments:
+		arena.
+
+	complexity O(number of slabs)
+*/
+void ArenaDestroy(arena_t *arena);
+
+/*
+	Take memory from the arena, it is only freed with the arena.
+	Blocks larger than a slab get a slab of their own.
+
+	arguments:
+		arena.
+		size - bytes, aligned for any type.
+
+	returns the memory, NULL on failure.
+
+	complexity O(1)
+*/
+void *ArenaAlloc(arena_t *arena, size_t size);
+
+/*
+	Number of slabs taken from the system so far.
+
+	arguments:
+		arena.
+
+	complexity O(1)
+*/
+size_t ArenaSlabCount(const arena_t *arena);
+
+/*
+	Creates a pool of fixed size elements on top of an arena.
+	Freed elements are kept for reuse, the pool itself lives
+	in the arena and goes with it.
+	Elements are packed at pointer alignment, not for long double.
+
+	Arguments:
+		arena.
+		elem_size - bytes per element.
+
+	returns pool pointer, NULL on failure.
+
+	complexity O(1)
+*/
+pool_t *PoolCreate(arena_t *arena, size_t elem_size);
+
+/*
+	Take an element from the pool.
+
+	arguments:
+		pool.
+
+	returns the element, NULL on failure.
+
+	complexity O(1)
+*/
+void *PoolAlloc(pool_t *pool);
+
+/*
+	Give an element back to the pool it was taken from.
+
+	arguments:
+		pool.
+		elem - from PoolAlloc of the same pool.
+
+	complexity O(1)
+*/
+void PoolFree(pool_t *pool, void *elem);
+
+#endif /* ARENA_H */
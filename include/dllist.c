@@ -4,17 +4,62 @@ Header
 OL66
 Version 1
 ==============================================================================*/
+#define _POSIX_C_SOURCE (200112L)
 
 #include <stddef.h> /* size_t */
 #include <assert.h> /* assert */
 #include <stdlib.h> /* malloc */
+#include <string.h> /* memmove */
 
 #include "dllist.h"
 
 #define ITER_TO_NODE(x) ((dnode_t *)(x).info)
+#define ITER_TO_SLOT(x) ((void **)(x).info)
+#define IS_UNROLLED(list) (NULL != (list)->blocks)
+
+/* two cache lines per block, the adjacent line prefetcher pulls both */
+#define BLOCK_BYTES (128)
+#define BLOCK_SLOTS ((BLOCK_BYTES - 2 * sizeof(void *) - sizeof(long)) \
+														/ sizeof(void *))
+#define FULL_MASK ((1UL << BLOCK_SLOTS) - 1)
+#define BELOW(index) ((1UL << (index)) - 1)
+#define SLOT_TO_BLOCK(x) ((dblock_t *)((size_t)(x) & ~(size_t)(BLOCK_BYTES - 1)))
+#define SLOT_INDEX(x) ((size_t)((x) - SLOT_TO_BLOCK(x)->slots))
+
+typedef struct dblock dblock_t;
 
 static void ConnectNodes(dnode_t *pre, dnode_t *new, dnode_t *post);
 
+static dnode_t *NodeAlloc(dlist_t *list);
+
+static void NodeFree(dlist_t *list, dnode_t *node);
+
+/****
+					Block Functions
+****/
+static dblock_t *BlockAlloc(void);
+
+static void BlockLinkAfter(dblock_t *pre, dblock_t *block);
+
+static void BlockUnlink(dblock_t *block);
+
+static void **BlockFirst(dblock_t *block, size_t index);
+
+static void **BlockLast(dblock_t *block, size_t index);
+
+static void **BlockInsert(dlist_t *list, void **where, const void *data);
+
+static void **BlockPlace(dlist_t *list, dblock_t *block, size_t index,
+															const void *data);
+
+static int BlockSplit(dlist_t *list, diter_t *at, diter_t *keep1,
+															diter_t *keep2);
+
+static size_t HighBit(unsigned long mask);
+
+static int BlockForEach(void **from, void **to,
+			int (*operation_func)(void *data, void *argument), void *argument);
+
 struct dnode
 {
     void *data;
@@ -22,10 +67,29 @@ struct dnode
     dnode_t *prev;
 };
 
+/*
+	An unrolled list keeps elements in order across a ring of blocks,
+	mask has bit i set when slots[i] holds one. Free slots may be
+	anywhere, a block with none left is freed. The list's sentinel
+	block is always empty, an iterator points at a slot.
+*/
+struct dblock
+{
+    dblock_t *next;
+    dblock_t *prev;
+    unsigned long mask;
+    void *slots[BLOCK_SLOTS];
+};
+
 struct dlist_t
 {
     dnode_t first;
     dnode_t last;
+    dblock_t *blocks;
+    pool_t *pool;
+    size_t count;
+    size_t high_water;
+    size_t allocs;
 };
 
 /*---------------------------------------------------------------------------*/
@@ -35,7 +99,9 @@ diter_t DLBegin(const dlist_t *list)
 {
 	diter_t iter = {0};
 	assert(list);
-	iter.info = list->first.next;
+	iter.info = IS_UNROLLED(list) ? (void *)BlockFirst(list->blocks, 
+												BLOCK_SLOTS) : list->first.next;
+	iter.list = (dlist_t *)list;
 	return iter;
 }
 
@@ -43,7 +109,9 @@ diter_t DLEnd(const dlist_t *list)
 {
 	diter_t iter = {0};
 	assert(list);
-	iter.info = (dnode_t *)&list->last;
+	iter.info = IS_UNROLLED(list) ? (void *)list->blocks->slots :
+												(void *)&list->last;
+	iter.list = (dlist_t *)list;
 	return iter;
 }
 
@@ -52,6 +120,15 @@ diter_t DLNext(diter_t iter)
 	dnode_t *node = NULL;
 	
 	assert(iter.info);
+
+	if (IS_UNROLLED(iter.list))
+	{
+		void **slot = ITER_TO_SLOT(iter);
+
+		iter.info = BlockFirst(SLOT_TO_BLOCK(slot), SLOT_INDEX(slot) + 1);
+
+		return iter;
+	}
 	
 	node = iter.info;
 	node = node->next; 
@@ -65,6 +142,15 @@ diter_t DLPrev(diter_t iter)
 	dnode_t *node = NULL;
 	
 	assert(iter.info);
+
+	if (IS_UNROLLED(iter.list))
+	{
+		void **slot = ITER_TO_SLOT(iter);
+
+		iter.info = BlockLast(SLOT_TO_BLOCK(slot), SLOT_INDEX(slot));
+
+		return iter;
+	}
 	
 	node = iter.info;
 	node = node->prev; 
@@ -86,6 +172,11 @@ void *DLGetData(diter_t iter)
 	dnode_t *node = NULL;
 	
 	assert(iter.info);
+
+	if (IS_UNROLLED(iter.list))
+	{
+		return *ITER_TO_SLOT(iter);
+	}
 	
 	node = iter.info;
 	
@@ -111,6 +202,61 @@ dlist_t *DLCreate()
 	list->last.data = NULL;
 	list->first.next = &list->last;
 	list->last.prev = &list->first;
+	list->blocks = NULL;
+	list->pool = NULL;
+	list->count = 0;
+	list->high_water = 0;
+	list->allocs = 0;
+
+	return list;
+}
+
+dlist_t *DLCreateUnrolled(void)
+{
+	dlist_t *list = DLCreate();
+
+	if (NULL == list)
+	{
+		return NULL;
+	}
+
+	list->blocks = BlockAlloc();
+
+	if (NULL == list->blocks)
+	{
+		free(list);
+
+		return NULL;
+	}
+
+	list->blocks->next = list->blocks;
+	list->blocks->prev = list->blocks;
+
+	return list;
+}
+
+dlist_t *DLCreateFromArena(arena_t *arena)
+{
+	dlist_t *list = NULL;
+	pool_t *pool = NULL;
+
+	assert(arena);
+
+	pool = PoolCreate(arena, sizeof(dnode_t));
+
+	if (NULL == pool)
+	{
+		return NULL;
+	}
+
+	list = DLCreate();
+
+	if (NULL == list)
+	{
+		return NULL;
+	}
+
+	list->pool = pool;
 
 	return list;
 }
@@ -118,6 +264,22 @@ dlist_t *DLCreate()
 void DLDestroy(dlist_t *list)
 {
 	assert(list);
+
+	if (IS_UNROLLED(list))
+	{
+		while (list->blocks->next != list->blocks)
+		{
+			dblock_t *block = list->blocks->next;
+
+			BlockUnlink(block);
+			free(block);
+		}
+
+		free(list->blocks);
+		free(list);
+
+		return;
+	}
 	
 	while(!DLIsEmpty(list))
 	{
@@ -130,16 +292,19 @@ void DLDestroy(dlist_t *list)
 
 size_t DLCount(const dlist_t *list)
 {
-	diter_t iter = {0};
-	size_t count = 0;
 	assert(list);
 
-	for(iter = DLBegin(list); !DLIsSameIter(iter,DLEnd(list)) ; iter = DLNext(iter))
-	{
-		++count;
-	}  
+	return list->count;
+}
 
-	return count;
+void DLStats(const dlist_t *list, dl_stats_t *stats)
+{
+	assert(list);
+	assert(stats);
+
+	stats->size = list->count;
+	stats->high_water = list->high_water;
+	stats->allocs = list->allocs;
 }
 
 int DLIsEmpty(const dlist_t *list)
@@ -151,6 +316,22 @@ int DLIsEmpty(const dlist_t *list)
 diter_t DLInsert(dlist_t *list, diter_t iter, const void *data)
 {
 	assert(list);
+
+	if (IS_UNROLLED(list))
+	{
+		void **slot = BlockInsert(list, ITER_TO_SLOT(iter), data);
+
+		if (NULL == slot)
+		{
+			return DLEnd(list);
+		}
+
+		iter.info = slot;
+		iter.list = list;
+
+		return iter;
+	}
+
 	return DLInsertAfter(list, DLPrev(iter), data);	
 }
 
@@ -161,7 +342,12 @@ diter_t DLInsertAfter(dlist_t *list, diter_t iter, const void *data)
 	
 	assert(list);
 
-	node =(dnode_t*)malloc(sizeof(dnode_t));	
+	if (IS_UNROLLED(list))
+	{
+		return DLInsert(list, DLNext(iter), data);
+	}
+
+	node = NodeAlloc(list);	
 
 	if (NULL == node)
 	{
@@ -171,8 +357,14 @@ diter_t DLInsertAfter(dlist_t *list, diter_t iter, const void *data)
 	node->data =(void *) data;
 	
 	ConnectNodes(ITER_TO_NODE(iter), node, ITER_TO_NODE(iter)->next);
+
+	++list->allocs;
+	++list->count;
+	list->high_water = (list->count > list->high_water) ? list->count :
+														list->high_water;
 	
 	new.info = node;
+	new.list = list;
 	
 	return new;
 }
@@ -183,14 +375,34 @@ void DLErase(diter_t iter)
 	dnode_t *post = NULL;
 
 	assert(iter.info);	
+	assert(iter.list);
+
+	if (IS_UNROLLED(iter.list))
+	{
+		void **slot = ITER_TO_SLOT(iter);
+		dblock_t *block = SLOT_TO_BLOCK(slot);
+
+		block->mask &= ~(1UL << SLOT_INDEX(slot));
+		--iter.list->count;
+
+		if (0 == block->mask)
+		{
+			BlockUnlink(block);
+			free(block);
+		}
+
+		return;
+	}
 
 	pre = ITER_TO_NODE(iter)->prev;
 	post = ITER_TO_NODE(iter)->next;	
 
-	free(ITER_TO_NODE(iter));
+	NodeFree(iter.list, ITER_TO_NODE(iter));
 
 	pre->next = post;
 	post->prev = pre;
+
+	--iter.list->count;
 }
 
 diter_t DLPushFront(dlist_t *list, const void *data)
@@ -230,9 +442,15 @@ int DLForEach
 	assert(from.info);
 	assert(to.info);
 
+	if (IS_UNROLLED(from.list))
+	{
+		return BlockForEach(ITER_TO_SLOT(from), ITER_TO_SLOT(to),
+												operation_func, argument);
+	}
+
 	while(!DLIsSameIter(from,to) && 0 == res)
 	{
-		res = operation_func(ITER_TO_NODE(from)->data,argument);
+		res = operation_func(DLGetData(from),argument);
 		from = DLNext(from);
 	}
 	
@@ -255,7 +473,7 @@ diter_t DLFind
 	
 	while(!DLIsSameIter(from,to))
 	{
-		res = cmp_func(ITER_TO_NODE(from)->data,to_compare);
+		res = cmp_func(DLGetData(from),to_compare);
 		
 		if (1 == res)
 		{
@@ -268,7 +486,7 @@ diter_t DLFind
 	return to;
 }
 
-void DLSplice(diter_t from, diter_t to, diter_t dest)
+int DLSplice(diter_t from, diter_t to, diter_t dest)
 {
 	diter_t prev_to = {0};
 
@@ -276,6 +494,84 @@ void DLSplice(diter_t from, diter_t to, diter_t dest)
 	assert(to.info);
 	assert(dest.info);
 
+	if (DLIsSameIter(from, to))
+	{
+		return 0;
+	}
+
+	/* a node freed to another pool would corrupt it, or the heap */
+	if (!DLCanSplice(dest.list, from.list))
+	{
+		return 1;
+	}
+
+	if (IS_UNROLLED(from.list))
+	{
+		dblock_t *first = NULL;
+		dblock_t *last = NULL;
+		dblock_t *stop = NULL;
+		dblock_t *at = NULL;
+
+		assert(IS_UNROLLED(dest.list));
+
+		/* cut the range and the destination at block boundaries */
+		if (0 != BlockSplit(from.list, &to, &from, &dest) ||
+					0 != BlockSplit(from.list, &from, &to, &dest) ||
+					0 != BlockSplit(dest.list, &dest, &from, &to))
+		{
+			return 1;
+		}
+
+		first = SLOT_TO_BLOCK(ITER_TO_SLOT(from));
+		stop = SLOT_TO_BLOCK(ITER_TO_SLOT(to));
+		last = stop->prev;
+		at = SLOT_TO_BLOCK(ITER_TO_SLOT(dest));
+
+		if (from.list != dest.list)
+		{
+			dblock_t *block = first;
+			size_t moved = 0;
+
+			for (; block != stop; block = block->next)
+			{
+				moved += __builtin_popcountl(block->mask);
+			}
+
+			from.list->count -= moved;
+			dest.list->count += moved;
+			dest.list->high_water = (dest.list->count >
+				dest.list->high_water) ? dest.list->count :
+												dest.list->high_water;
+		}
+
+		first->prev->next = stop;
+		stop->prev = first->prev;
+
+		first->prev = at->prev;
+		at->prev->next = first;
+		last->next = at;
+		at->prev = last;
+
+		return 0;
+	}
+
+	/* the moved nodes are only counted when they change lists */
+	if (from.list != dest.list)
+	{
+		diter_t iter = from;
+		size_t moved = 0;
+
+		for (; !DLIsSameIter(iter, to); iter = DLNext(iter))
+		{
+			++moved;
+		}
+
+		from.list->count -= moved;
+		dest.list->count += moved;
+		dest.list->high_water = (dest.list->count > dest.list->high_water) ?
+								dest.list->count : dest.list->high_water;
+	}
+
 	prev_to = DLPrev(to);
 
 	ITER_TO_NODE(prev_to)->next->prev = ITER_TO_NODE(from)->prev;
@@ -287,7 +583,95 @@ void DLSplice(diter_t from, diter_t to, diter_t dest)
 	ITER_TO_NODE(dest)->prev = ITER_TO_NODE(prev_to);
 	ITER_TO_NODE(prev_to)->next = ITER_TO_NODE(dest);
 
+	return 0;
+}
+int DLCanSplice(const dlist_t *dest, const dlist_t *src)
+{
+	assert(dest);
+	assert(src);
+
+	return (dest->pool == src->pool && IS_UNROLLED(dest) == IS_UNROLLED(src));
+}
+
+/*---------------------------------------------------------------------------*/
+/* Intrusive list functions: */
+
+void DLLinkInit(dlink_t *head)
+{
+	assert(head);
+
+	head->next = head;
+	head->prev = head;
 }
+
+int DLLinkIsEmpty(const dlink_t *head)
+{
+	assert(head);
+
+	return (head->next == head);
+}
+
+size_t DLLinkCount(const dlink_t *head)
+{
+	const dlink_t *link = NULL;
+	size_t count = 0;
+
+	assert(head);
+
+	for (link = head->next; link != head; link = link->next)
+	{
+		++count;
+	}
+
+	return count;
+}
+
+void DLLinkInsert(dlink_t *where, dlink_t *link)
+{
+	assert(where);
+	assert(link);
+
+	link->next = where;
+	link->prev = where->prev;
+	where->prev->next = link;
+	where->prev = link;
+}
+
+void DLLinkErase(dlink_t *link)
+{
+	assert(link);
+
+	link->prev->next = link->next;
+	link->next->prev = link->prev;
+	link->next = NULL;
+	link->prev = NULL;
+}
+
+void DLLinkSplice(dlink_t *from, dlink_t *to, dlink_t *dest)
+{
+	dlink_t *last = NULL;
+
+	assert(from);
+	assert(to);
+	assert(dest);
+
+	if (from == to)
+	{
+		return;
+	}
+
+	last = to->prev;
+
+	from->prev->next = to;
+	to->prev = from->prev;
+
+	from->prev = dest->prev;
+	dest->prev->next = from;
+
+	last->next = dest;
+	dest->prev = last;
+}
+
 /****************************************************************
 HELPER FUNCTION
 ***************************************************************/
@@ -299,3 +683,284 @@ static void ConnectNodes(dnode_t *pre, dnode_t *new, dnode_t *post)
 	post->prev = new;
 }
 
+static dnode_t *NodeAlloc(dlist_t *list)
+{
+	if (NULL != list->pool)
+	{
+		return (dnode_t *)PoolAlloc(list->pool);
+	}
+
+	return (dnode_t *)malloc(sizeof(dnode_t));
+}
+
+static void NodeFree(dlist_t *list, dnode_t *node)
+{
+	if (NULL != list->pool)
+	{
+		PoolFree(list->pool, node);
+
+		return;
+	}
+
+	free(node);
+}
+
+/****************************************************************
+BLOCK FUNCTIONS
+***************************************************************/
+static dblock_t *BlockAlloc(void)
+{
+	void *block = NULL;
+
+	if (0 != posix_memalign(&block, BLOCK_BYTES, sizeof(dblock_t)))
+	{
+		return NULL;
+	}
+
+	((dblock_t *)block)->mask = 0;
+
+	return (dblock_t *)block;
+}
+
+static void BlockLinkAfter(dblock_t *pre, dblock_t *block)
+{
+	block->prev = pre;
+	block->next = pre->next;
+	pre->next->prev = block;
+	pre->next = block;
+}
+
+static void BlockUnlink(dblock_t *block)
+{
+	block->prev->next = block->next;
+	block->next->prev = block->prev;
+}
+
+/* the first element from index on, in this block or the next ones */
+static void **BlockFirst(dblock_t *block, size_t index)
+{
+	unsigned long mask = block->mask >> index;
+
+	if (0 != mask)
+	{
+		return &block->slots[index + __builtin_ctzl(mask)];
+	}
+
+	block = block->next;
+
+	/* only the sentinel is empty, it is End */
+	if (0 == block->mask)
+	{
+		return block->slots;
+	}
+
+	return &block->slots[__builtin_ctzl(block->mask)];
+}
+
+/* the last element before index, in this block or the ones before it */
+static void **BlockLast(dblock_t *block, size_t index)
+{
+	unsigned long mask = block->mask & BELOW(index);
+
+	if (0 != mask)
+	{
+		return &block->slots[HighBit(mask)];
+	}
+
+	block = block->prev;
+
+	if (0 == block->mask)
+	{
+		return block->slots;
+	}
+
+	return &block->slots[HighBit(block->mask)];
+}
+
+/*
+	Places data right before where. Only a full block is split, and
+	only elements between where and the nearest free slot move.
+*/
+static void **BlockInsert(dlist_t *list, void **where, const void *data)
+{
+	dblock_t *block = SLOT_TO_BLOCK(where);
+	size_t index = SLOT_INDEX(where);
+	dblock_t *pre = block->prev;
+	dblock_t *new = NULL;
+	unsigned long free_above = 0;
+	size_t free_slot = 0;
+
+	if (0 == (block->mask & BELOW(index)))
+	{
+		if (0 != pre->mask && 0 == (pre->mask >> (BLOCK_SLOTS - 1)))
+		{
+			return BlockPlace(list, pre, HighBit(pre->mask) + 1, data);
+		}
+
+		if (0 != index)
+		{
+			return BlockPlace(list, block, index - 1, data);
+		}
+
+		new = BlockAlloc();
+
+		if (NULL == new)
+		{
+			return NULL;
+		}
+
+		++list->allocs;
+		BlockLinkAfter(pre, new);
+
+		/* appends fill a block upwards, front inserts downwards */
+		return BlockPlace(list, new, (block == list->blocks) ? 0 :
+													BLOCK_SLOTS - 1, data);
+	}
+
+	if (0 == (block->mask & (1UL << (index - 1))))
+	{
+		return BlockPlace(list, block, index - 1, data);
+	}
+
+	if (FULL_MASK == block->mask)
+	{
+		new = BlockAlloc();
+
+		if (NULL == new)
+		{
+			return NULL;
+		}
+
+		/* the upper half moves to the same slots of a new block */
+		++list->allocs;
+		BlockLinkAfter(block, new);
+		memcpy(new->slots + BLOCK_SLOTS / 2, block->slots + BLOCK_SLOTS / 2,
+							(BLOCK_SLOTS - BLOCK_SLOTS / 2) * sizeof(void *));
+		new->mask = block->mask & ~BELOW(BLOCK_SLOTS / 2);
+		block->mask &= BELOW(BLOCK_SLOTS / 2);
+
+		return BlockInsert(list, (index < BLOCK_SLOTS / 2) ? where :
+											&new->slots[index], data);
+	}
+
+	free_above = ~block->mask & FULL_MASK & ~BELOW(index);
+
+	if (0 != free_above)
+	{
+		free_slot = __builtin_ctzl(free_above);
+		memmove(&block->slots[index + 1], &block->slots[index],
+									(free_slot - index) * sizeof(void *));
+		block->mask |= 1UL << free_slot;
+
+		return BlockPlace(list, block, index, data);
+	}
+
+	free_slot = HighBit(~block->mask & BELOW(index));
+	memmove(&block->slots[free_slot], &block->slots[free_slot + 1],
+								(index - 1 - free_slot) * sizeof(void *));
+	block->mask |= 1UL << free_slot;
+
+	return BlockPlace(list, block, index - 1, data);
+}
+
+static void **BlockPlace(dlist_t *list, dblock_t *block, size_t index,
+															const void *data)
+{
+	block->slots[index] = (void *)data;
+	block->mask |= 1UL << index;
+	++list->count;
+	list->high_water = (list->count > list->high_water) ? list->count :
+														list->high_water;
+
+	return &block->slots[index];
+}
+
+/*
+	Moves at and the elements after it in its block to a new block,
+	unless it is first in its block. Iterators into the moved slots
+	are updated.
+*/
+static int BlockSplit(dlist_t *list, diter_t *at, diter_t *keep1,
+															diter_t *keep2)
+{
+	void **slot = ITER_TO_SLOT(*at);
+	dblock_t *block = SLOT_TO_BLOCK(slot);
+	size_t index = SLOT_INDEX(slot);
+	diter_t *iters[3];
+	dblock_t *new = NULL;
+	size_t i = 0;
+
+	if (0 == (block->mask & BELOW(index)))
+	{
+		return 0;
+	}
+
+	new = BlockAlloc();
+
+	if (NULL == new)
+	{
+		return 1;
+	}
+
+	++list->allocs;
+	BlockLinkAfter(block, new);
+	memcpy(new->slots + index, block->slots + index,
+								(BLOCK_SLOTS - index) * sizeof(void *));
+	new->mask = block->mask & ~BELOW(index);
+	block->mask &= BELOW(index);
+
+	iters[0] = at;
+	iters[1] = keep1;
+	iters[2] = keep2;
+
+	for (i = 0; i < 3; ++i)
+	{
+		void **moved = ITER_TO_SLOT(*iters[i]);
+
+		if (SLOT_TO_BLOCK(moved) == block && SLOT_INDEX(moved) >= index)
+		{
+			iters[i]->info = &new->slots[SLOT_INDEX(moved)];
+		}
+	}
+
+	return 0;
+}
+
+static size_t HighBit(unsigned long mask)
+{
+	return sizeof(unsigned long) * 8 - 1 - __builtin_clzl(mask);
+}
+
+/* walks the masks directly instead of one DLNext per element */
+static int BlockForEach(void **from, void **to,
+			int (*operation_func)(void *data, void *argument), void *argument)
+{
+	dblock_t *block = SLOT_TO_BLOCK(from);
+	unsigned long mask = block->mask & ~BELOW(SLOT_INDEX(from));
+	int res = 0;
+
+	while (0 != block->mask)
+	{
+		for (; 0 != mask; mask &= mask - 1)
+		{
+			void **slot = &block->slots[__builtin_ctzl(mask)];
+
+			if (slot == to)
+			{
+				return res;
+			}
+
+			res = operation_func(*slot, argument);
+
+			if (0 != res)
+			{
+				return res;
+			}
+		}
+
+		block = block->next;
+		mask = block->mask;
+	}
+
+	return res;
+}
@@ -9,6 +9,7 @@ Version 1
 
 
 #include <stddef.h> /* size_t */
+#include "arena.h"  /* arena_t */
 
 typedef struct dnode dnode_t;
 /*
@@ -26,14 +27,26 @@ struct dlist
 {
     dnode_t head;
     dnode_t tail;
+    pool_t *pool;
+    size_t count;
+    size_t high_water;
+    size_t allocs;
 };
 */
 
+typedef struct
+{
+	size_t size;
+	size_t high_water;
+	size_t allocs;
+} dl_stats_t;
+
 typedef struct
 {
 	int a;
   	void *info;
 	int b;
+	dlist_t *list;
 } diter_t;
 
 /*---------------------------------------------------------------------------*/
@@ -118,6 +131,34 @@ void *DLGetData(diter_t iter);
 */
 dlist_t *DLCreate();
 
+/*
+	Creates a new unrolled list, elements are kept in order in
+	cache line aligned blocks of pointers instead of a node each,
+	so walking it touches one block per several elements.
+	All other DL functions work on it unchanged, except that an
+	insert may move other elements of the block it lands in and
+	invalidate iterators to them. Erase invalidates only its own.
+
+	returns list pointer, NULL on failure.
+
+	complexity O(1)
+*/
+dlist_t *DLCreateUnrolled(void);
+
+/*
+	Creates a new list that takes its nodes from a pool in arena,
+	so inserts do not call malloc once the pool is warm.
+	Nodes go back to the pool, the arena must outlive the list.
+
+	Arguments:
+		arena.
+
+	returns list pointer, NULL on failure.
+
+	complexity O(1)
+*/
+dlist_t *DLCreateFromArena(arena_t *arena);
+
 /*
 	Destroy a given list.
 
@@ -136,10 +177,26 @@ void DLDestroy(dlist_t *list);
 
 	returns number of elements.
 
-	complexity O(n)
+	The count is kept by the calls on the list, an erase goes to
+	the list its iterator names. It holds as long as iterators to
+	nodes moved by DLSplice are taken again, see there.
+
+	complexity O(1)
 */
 size_t DLCount(const dlist_t *list);
 
+/*
+	Fill stats for a given list: its size, the largest size
+	it had, and the number of nodes it allocated.
+
+	arguments:
+		list.
+		stats - filled by the function.
+
+	complexity O(1)
+*/
+void DLStats(const dlist_t *list, dl_stats_t *stats);
+
 /*
 	For a given list, return true if empty,
 	false otherwise.
@@ -185,7 +242,9 @@ diter_t DLInsertAfter(dlist_t *list, diter_t iter, const void *data);
 	Remove a given element from the list
 
 	arguments:
-		iterator - to the element to be removed.
+		iterator - to the element to be removed, from the list
+				that holds it now, not one from before a DLSplice
+				moved it to another list.
 
 	complexity O(1)
 */
@@ -291,10 +350,128 @@ diter_t DLFind(
 		from - where to start the connection
 		to - where to end the connection (not included)
 
+	Nodes may only move between lists made by DLCreate, within
+	one list made by DLCreateFromArena (each has its own pool),
+	and unrolled lists only with unrolled lists, see DLCanSplice.
+	Iterators to nodes moved to another list still name the old
+	one: take them again from dest, erasing through an old one
+	leaves both counts wrong.
+
+	returns 0 on success. Returns 1 and leaves the lists unchanged
+	if the lists take nodes from different pools, or if an unrolled
+	list fails to split a block.
+
+	complexity O(1) within a list,
+	O(k) for k nodes moved to another list, to keep the counts.
+*/
+int DLSplice(diter_t from, diter_t to, diter_t dest);
+
+/*
+	Checks if DLSplice may move nodes from src to dest.
+
+	arguments:
+		dest.
+		src.
+
+	returns true if both lists take nodes from the same place.
+
 	complexity O(1)
 */
-void DLSplice(diter_t from, diter_t to, diter_t dest);
+int DLCanSplice(const dlist_t *dest, const dlist_t *src);
 
+/*---------------------------------------------------------------------------*/
+/* Intrusive list functions: */
+
+typedef struct dlink_s dlink_t;
 
+/*
+				WARNING!!!
+struct definition is for use of implementor,
+any changes to it will result in undefined behaviour.
+The link is embedded by the user in the element it represents,
+the list is a dlink_t used as head, and nothing is allocated.
+Walk it from head->next until reaching the head again.
+*/
+struct dlink_s
+{
+	dlink_t *next;
+	dlink_t *prev;
+};
+
+/*
+	Returns the element a given link is embedded in.
+
+	Arguments:
+		link - pointer to the embedded link.
+		type - type of the element.
+		member - name of the link field in type.
+*/
+#define DL_ENTRY(link, type, member) \
+					((type *)((char *)(link) - offsetof(type, member)))
+
+/*
+	Initialize a given head to an empty list.
+
+	Arguments:
+		head.
+
+	complexity O(1)
+*/
+void DLLinkInit(dlink_t *head);
+
+/*
+	For a given head, return true if empty,
+	false otherwise.
+
+	Arguments:
+		head.
+
+	complexity O(1)
+*/
+int DLLinkIsEmpty(const dlink_t *head);
+
+/*
+	Count number of links in a given list.
+
+	Arguments:
+		head.
+
+	complexity O(n)
+*/
+size_t DLLinkCount(const dlink_t *head);
+
+/*
+	Insert a link before a given position.
+
+	Arguments:
+		where - link in a list, the head to insert last.
+		link - link that is in no list.
+
+	complexity O(1)
+*/
+void DLLinkInsert(dlink_t *where, dlink_t *link);
+
+/*
+	Remove a given link from its list.
+	The element is not touched and may be inserted again.
+
+	Arguments:
+		link.
+
+	complexity O(1)
+*/
+void DLLinkErase(dlink_t *link);
+
+/*
+	Move the links from, up to to (not included), before dest.
+
+	Arguments:
+		from - first link to move.
+		to - where to end the move (not included).
+		dest - connection point, in this or another list.
+
+	complexity O(1)
+*/
+void DLLinkSplice(dlink_t *from, dlink_t *to, dlink_t *dest);
 
 #endif /* DOUBLE_LINK_LIST_H */
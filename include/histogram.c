@@ -0,0 +1,147 @@
+/*==============================================================================
+Data Structures - Log Linear Histogram
+Source
+OL66
+Version 1
+==============================================================================*/
+
+#include <stddef.h> /* size_t */
+#include <assert.h> /* assert */
+#include <string.h> /* memset */
+
+#include "histogram.h"
+
+#define SUB_COUNT ((size_t)1 << HIST_SUB_BITS)
+#define SUB_MASK (SUB_COUNT - 1)
+
+static size_t BucketOf(size_t value);
+static size_t BucketTop(size_t bucket);
+
+void HistInit(hist_t *hist)
+{
+	assert(hist);
+
+	memset(hist, 0, sizeof(hist_t));
+	hist->min = (size_t)-1;
+}
+
+void HistRecord(hist_t *hist, size_t value)
+{
+	assert(hist);
+
+	++hist->buckets[BucketOf(value)];
+	++hist->count;
+	hist->sum += value;
+
+	if (value < hist->min)
+	{
+		hist->min = value;
+	}
+
+	if (value > hist->max)
+	{
+		hist->max = value;
+	}
+}
+
+size_t HistPercentile(const hist_t *hist, double percentile)
+{
+	size_t rank = 0;
+	size_t seen = 0;
+	size_t bucket = 0;
+
+	assert(hist);
+	assert(0 <= percentile && 100 >= percentile);
+
+	if (0 == hist->count)
+	{
+		return 0;
+	}
+
+	/* the first value at or above the share, at least the first one */
+	rank = (size_t)(percentile / 100 * (double)hist->count + 0.5);
+	rank = (0 == rank) ? 1 : rank;
+
+	for (bucket = 0; bucket < HIST_BUCKETS; ++bucket)
+	{
+		seen += hist->buckets[bucket];
+
+		if (seen >= rank)
+		{
+			break;
+		}
+	}
+
+	return (BucketTop(bucket) < hist->max) ? BucketTop(bucket) : hist->max;
+}
+
+void HistMerge(hist_t *dest, const hist_t *src)
+{
+	size_t bucket = 0;
+
+	assert(dest);
+	assert(src);
+
+	for (bucket = 0; bucket < HIST_BUCKETS; ++bucket)
+	{
+		dest->buckets[bucket] += src->buckets[bucket];
+	}
+
+	dest->count += src->count;
+	dest->sum += src->sum;
+
+	if (src->min < dest->min)
+	{
+		dest->min = src->min;
+	}
+
+	if (src->max > dest->max)
+	{
+		dest->max = src->max;
+	}
+}
+
+/****************************************************************
+HELPER FUNCTION
+***************************************************************/
+/* the top bit picks the group, the next HIST_SUB_BITS bits the bucket */
+static size_t BucketOf(size_t value)
+{
+	size_t top = 0;
+
+	if (value < SUB_COUNT)
+	{
+		return value;
+	}
+
+	if (value >> HIST_MAX_BITS)
+	{
+		return HIST_BUCKETS - 1;
+	}
+
+	top = sizeof(unsigned long) * 8 - 1 - __builtin_clzl(value);
+
+	return ((top - HIST_SUB_BITS + 1) << HIST_SUB_BITS) +
+							((value >> (top - HIST_SUB_BITS)) & SUB_MASK);
+}
+
+static size_t BucketTop(size_t bucket)
+{
+	size_t group = bucket >> HIST_SUB_BITS;
+	size_t shift = 0;
+
+	if (0 == group)
+	{
+		return bucket;
+	}
+
+	if (HIST_BUCKETS - 1 == bucket)
+	{
+		return (size_t)-1;
+	}
+
+	shift = group - 1;
+
+	return (((bucket & SUB_MASK) | SUB_COUNT) << shift) +
+												(((size_t)1 << shift) - 1);
+}
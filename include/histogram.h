@@ -0,0 +1,82 @@
+/*==============================================================================
+Data Structures - Log Linear Histogram
+Header
+OL66
+Version 1
+==============================================================================*/
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stddef.h> /* size_t */
+
+#define HIST_SUB_BITS (5)
+#define HIST_MAX_BITS (40)
+#define HIST_BUCKETS ((HIST_MAX_BITS - HIST_SUB_BITS + 1) << HIST_SUB_BITS)
+
+/*
+	Values below 2^HIST_SUB_BITS get a bucket each, every power of two
+	above is split in 2^HIST_SUB_BITS buckets, so a bucket is within
+	about 3% of the values in it. Values from 2^HIST_MAX_BITS up share
+	the last bucket (about 18 minutes in nanoseconds).
+	A plain struct of counters: it can be embedded, copied as a snapshot
+	and written out as is.
+
+	count, min, max and sum may be read directly,
+	buckets only through HistPercentile.
+*/
+typedef struct hist_s
+{
+	size_t count;
+	size_t min;
+	size_t max;
+	size_t sum;
+	size_t buckets[HIST_BUCKETS];
+} hist_t;
+
+/*
+	Empties a histogram.
+
+	Arguments:
+		hist - histogram.
+
+	complexity O(buckets)
+*/
+void HistInit(hist_t *hist);
+
+/*
+	Counts one value.
+
+	Arguments:
+		hist - histogram.
+		value - value to count.
+
+	complexity O(1)
+*/
+void HistRecord(hist_t *hist, size_t value);
+
+/*
+	Value below which a given share of the counted values falls.
+
+	Arguments:
+		hist - histogram.
+		percentile - 0 to 100.
+
+	returns the highest value of the bucket it falls in, capped by max,
+	0 for an empty histogram.
+
+	complexity O(buckets)
+*/
+size_t HistPercentile(const hist_t *hist, double percentile);
+
+/*
+	Adds the counts of one histogram to another.
+
+	Arguments:
+		dest - histogram to add to.
+		src - histogram to add.
+
+	complexity O(buckets)
+*/
+void HistMerge(hist_t *dest, const hist_t *src);
+
+#endif /* HISTOGRAM_H */
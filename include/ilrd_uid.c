@@ -8,12 +8,11 @@ ilrd_uid_t UIDGet()
 	
 	ilrd_uid_t uid = {0};
 
-	uid.counter = count;
+	/* SchAdd may be called from several threads */
+	uid.counter = __sync_fetch_and_add(&count, 1);
 	uid.pid = getpid();
 	gettimeofday(&uid.time,NULL);
 
-	++count;	
-
 	return uid;
 }
 
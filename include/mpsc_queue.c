@@ -0,0 +1,115 @@
+/*==============================================================================
+Data Structures - Lock Free MPSC Queue
+Source
+OL66
+Version 1
+==============================================================================*/
+
+#include <stddef.h> /* NULL   */
+#include <assert.h> /* assert */
+#include <stdlib.h> /* malloc */
+
+#include "mpsc_queue.h"
+
+/* producers swap themselves into tail, the consumer owns head,
+   stub keeps the list non empty so the two never meet */
+struct mpsc_queue_s
+{
+	mpsc_node_t *head;
+	mpsc_node_t *tail;
+	mpsc_node_t stub;
+};
+
+mpsc_queue_t *MPSCQueueCreate(void)
+{
+	mpsc_queue_t *queue = (mpsc_queue_t *)malloc(sizeof(mpsc_queue_t));
+
+	if (NULL == queue)
+	{
+		return NULL;
+	}
+
+	queue->stub.next = NULL;
+	queue->head = &queue->stub;
+	queue->tail = &queue->stub;
+
+	return queue;
+}
+
+void MPSCQueueDestroy(mpsc_queue_t *queue)
+{
+	assert(queue);
+
+	free(queue);
+	queue = NULL;
+}
+
+void MPSCQueuePush(mpsc_queue_t *queue, mpsc_node_t *node)
+{
+	mpsc_node_t *prev = NULL;
+
+	assert(queue);
+	assert(node);
+
+	node->next = NULL;
+	prev = __atomic_exchange_n(&queue->tail, node, __ATOMIC_SEQ_CST);
+
+	/* between the exchange and this store the consumer sees a gap */
+	__atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+}
+
+mpsc_node_t *MPSCQueuePop(mpsc_queue_t *queue)
+{
+	mpsc_node_t *head = NULL;
+	mpsc_node_t *next = NULL;
+
+	assert(queue);
+
+	head = queue->head;
+	next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+
+	if (head == &queue->stub)
+	{
+		if (NULL == next)
+		{
+			return NULL;
+		}
+
+		queue->head = next;
+		head = next;
+		next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+	}
+
+	if (NULL != next)
+	{
+		queue->head = next;
+
+		return head;
+	}
+
+	if (head != __atomic_load_n(&queue->tail, __ATOMIC_SEQ_CST))
+	{
+		return NULL;
+	}
+
+	/* last node, put the stub behind it before handing it out */
+	MPSCQueuePush(queue, &queue->stub);
+	next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+
+	if (NULL != next)
+	{
+		queue->head = next;
+
+		return head;
+	}
+
+	return NULL;
+}
+
+int MPSCQueueIsEmpty(const mpsc_queue_t *queue)
+{
+	assert(queue);
+
+	return (queue->head == &queue->stub &&
+			&queue->stub == __atomic_load_n(&queue->tail, __ATOMIC_SEQ_CST));
+}
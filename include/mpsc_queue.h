@@ -0,0 +1,92 @@
+/*==============================================================================
+Data Structures - Lock Free MPSC Queue
+Header
+OL66
+Version 1
+==============================================================================*/
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+typedef struct mpsc_node_s mpsc_node_t;
+
+/*
+                        WARNING!!!
+struct definition is for use of implementor,
+any changes to it will result in undefined behaviour.
+The node is embedded by the user in the element it represents.
+*/
+struct mpsc_node_s
+{
+	mpsc_node_t *next;
+};
+
+typedef struct mpsc_queue_s mpsc_queue_t;
+/*
+struct mpsc_queue_s
+{
+	mpsc_node_t *head;
+	mpsc_node_t *tail;
+	mpsc_node_t stub;
+};
+*/
+
+/*
+	Creates a new multi producer, single consumer queue.
+
+	returns queue pointer, NULL on failure.
+
+	complexity O(1)
+*/
+mpsc_queue_t *MPSCQueueCreate(void);
+
+/*
+	Destroy a given queue.
+	Nodes still queued are not touched.
+
+	arguments:
+		queue.
+
+	complexity O(1)
+*/
+void MPSCQueueDestroy(mpsc_queue_t *queue);
+
+/*
+	Push a node to the back of the queue.
+	Safe from any number of threads at once, never blocks.
+
+	arguments:
+		queue.
+		node - not in any queue.
+
+	complexity O(1)
+*/
+void MPSCQueuePush(mpsc_queue_t *queue, mpsc_node_t *node);
+
+/*
+	Pop the node at the front of the queue.
+	Consumer thread only.
+
+	arguments:
+		queue.
+
+	returns the node, NULL if empty or if the front push is not
+	finished yet - the queue is not empty then, try again later.
+
+	complexity O(1)
+*/
+mpsc_node_t *MPSCQueuePop(mpsc_queue_t *queue);
+
+/*
+	Checks if a given queue is empty, pushes in progress count as queued.
+	Consumer thread only.
+
+	arguments:
+		queue.
+
+	returns true if empty, false otherwise.
+
+	complexity O(1)
+*/
+int MPSCQueueIsEmpty(const mpsc_queue_t *queue);
+
+#endif /* MPSC_QUEUE_H */
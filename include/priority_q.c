@@ -4,12 +4,47 @@
 #include "priority_q.h"
 
 #define NEED_TO_ERASE (1)
+#define DEFAULT_ARITY (4)
+#define INITIAL_CAPACITY (16)
+
+typedef struct
+{
+	void *data;
+	size_t key;
+	size_t seq;
+} heap_entry_t;
 
 struct pq_s
 {
 	sortedlist_t *p_q;
+	heap_entry_t *heap;
+	size_t size;
+	size_t high_water;
+	size_t allocs;
+	size_t capacity;
+	size_t arity;
+	size_t seq;
+	is_prior_t is_prior;
+	pq_index_t set_index;
 };
 
+/*********************************************************************
+					Heap Functions
+*********************************************************************/
+static int HeapIsBefore(const pq_t *pq, const heap_entry_t *a,
+												const heap_entry_t *b);
+
+static void HeapSiftUp(pq_t *pq, size_t index);
+
+static void HeapSiftDown(pq_t *pq, size_t index);
+
+static int HeapGrow(pq_t *pq);
+
+static void HeapPlace(pq_t *pq, size_t index, heap_entry_t entry);
+
+static int HeapPush(pq_t *pq, void *data, size_t key);
+
+
 pq_t *PriorityQCreate(is_prior_t is_prior)
 {
 	pq_t *pq =(pq_t *)malloc(sizeof(pq_t));
@@ -26,15 +61,171 @@ pq_t *PriorityQCreate(is_prior_t is_prior)
 		free(pq);
 		return NULL;
 	} 
+
+	pq->heap = NULL;
+	pq->size = 0;
+	pq->high_water = 0;
+	pq->allocs = 0;
+	pq->capacity = 0;
+	pq->arity = 0;
+	pq->seq = 0;
+	pq->is_prior = is_prior;
+	pq->set_index = NULL;
+	
+	return pq;
+}
+
+pq_t *PriorityQCreateFromArena(is_prior_t is_prior, arena_t *arena)
+{
+	pq_t *pq =(pq_t *)malloc(sizeof(pq_t));
+
+	assert(arena);
+	
+	if (NULL == pq)
+	{
+		return NULL;
+	}
+
+	pq->p_q = SortedListCreateFromArena(is_prior, arena);
+
+	if (NULL == pq->p_q)
+	{
+		free(pq);
+		return NULL;
+	} 
+
+	pq->heap = NULL;
+	pq->size = 0;
+	pq->high_water = 0;
+	pq->allocs = 0;
+	pq->capacity = 0;
+	pq->arity = 0;
+	pq->seq = 0;
+	pq->is_prior = is_prior;
+	pq->set_index = NULL;
+	
+	return pq;
+}
+
+pq_t *PriorityQCreateIntrusive(is_prior_t is_prior, size_t link_offset)
+{
+	pq_t *pq =(pq_t *)malloc(sizeof(pq_t));
+
+	if (NULL == pq)
+	{
+		return NULL;
+	}
+
+	pq->p_q = SortedListCreateIntrusive(is_prior, link_offset);
+
+	if (NULL == pq->p_q)
+	{
+		free(pq);
+		return NULL;
+	} 
+
+	pq->heap = NULL;
+	pq->size = 0;
+	pq->high_water = 0;
+	pq->allocs = 0;
+	pq->capacity = 0;
+	pq->arity = 0;
+	pq->seq = 0;
+	pq->is_prior = is_prior;
+	pq->set_index = NULL;
 	
 	return pq;
 }
 
+pq_t *PriorityQCreateHeap(is_prior_t is_prior, size_t arity)
+{
+	pq_t *pq =(pq_t *)malloc(sizeof(pq_t));
+
+	assert(is_prior);
+
+	if (NULL == pq)
+	{
+		return NULL;
+	}
+
+	pq->heap = (heap_entry_t *)malloc(INITIAL_CAPACITY * sizeof(heap_entry_t));
+
+	if (NULL == pq->heap)
+	{
+		free(pq);
+		return NULL;
+	}
+
+	pq->p_q = NULL;
+	pq->size = 0;
+	pq->high_water = 0;
+	pq->allocs = 1;
+	pq->capacity = INITIAL_CAPACITY;
+	pq->arity = (arity < 2) ? DEFAULT_ARITY : arity;
+	pq->seq = 0;
+	pq->is_prior = is_prior;
+	pq->set_index = NULL;
+
+	return pq;
+}
+
+pq_t *PriorityQCreateIndexed(is_prior_t is_prior, size_t arity,
+												pq_index_t set_index)
+{
+	pq_t *pq = PriorityQCreateHeap(is_prior, arity);
+
+	assert(set_index);
+
+	if (NULL == pq)
+	{
+		return NULL;
+	}
+
+	pq->set_index = set_index;
+
+	return pq;
+}
+
+pq_t *PriorityQCreateKeyed(size_t arity, pq_index_t set_index)
+{
+	pq_t *pq =(pq_t *)malloc(sizeof(pq_t));
+
+	if (NULL == pq)
+	{
+		return NULL;
+	}
+
+	pq->heap = (heap_entry_t *)malloc(INITIAL_CAPACITY * sizeof(heap_entry_t));
+
+	if (NULL == pq->heap)
+	{
+		free(pq);
+		return NULL;
+	}
+
+	pq->p_q = NULL;
+	pq->size = 0;
+	pq->high_water = 0;
+	pq->allocs = 1;
+	pq->capacity = INITIAL_CAPACITY;
+	pq->arity = (arity < 2) ? DEFAULT_ARITY : arity;
+	pq->seq = 0;
+	pq->is_prior = NULL;
+	pq->set_index = set_index;
+
+	return pq;
+}
+
 void PriorityQDestroy(pq_t *pq)
 {
 	assert(pq);
 	
-	SortedListDestroy(pq->p_q);
+	if (NULL != pq->p_q)
+	{
+		SortedListDestroy(pq->p_q);
+	}
+
+	free(pq->heap);
 	free(pq);
 	
 	pq = NULL;	
@@ -45,16 +236,42 @@ int PriorityQEnqueue(pq_t *pq, void *data)
 	sliter_t iter = {0};
 	
 	assert(pq);	
+
+	if (NULL == pq->p_q)
+	{
+		assert(pq->is_prior);
+
+		return HeapPush(pq, data, 0);
+	}
 	
 	iter = SortedListInsert(pq->p_q,data);
 
 	return SortedListIsSameIter(iter,SortedListEnd(pq->p_q)); 
 }
 
+int PriorityQEnqueueKeyed(pq_t *pq, void *data, size_t key)
+{
+	assert(pq);
+	assert(NULL == pq->p_q && NULL == pq->is_prior);
+
+	return HeapPush(pq, data, key);
+}
+
 void PriorityQDequeue(pq_t *pq)
 {
 	assert(pq);	
 
+	if (NULL == pq->p_q)
+	{
+		assert(0 < pq->size);
+
+		--pq->size;
+		HeapPlace(pq, 0, pq->heap[pq->size]);
+		HeapSiftDown(pq, 0);
+
+		return;
+	}
+
 	SortedListPopBack(pq->p_q);	
 }
 
@@ -62,13 +279,45 @@ size_t PriorityQSize(const pq_t *pq)
 {
 	assert(pq);	
 
+	if (NULL == pq->p_q)
+	{
+		return pq->size;
+	}
+
 	return SortedListCount(pq->p_q);
 }
 
+void PriorityQStats(const pq_t *pq, pq_stats_t *stats)
+{
+	sl_stats_t sl_stats = {0};
+
+	assert(pq);
+	assert(stats);
+
+	if (NULL == pq->p_q)
+	{
+		stats->size = pq->size;
+		stats->high_water = pq->high_water;
+		stats->allocs = pq->allocs;
+
+		return;
+	}
+
+	SortedListStats(pq->p_q, &sl_stats);
+	stats->size = sl_stats.size;
+	stats->high_water = sl_stats.high_water;
+	stats->allocs = sl_stats.allocs;
+}
+
 int PriorityQIsEmpty(const pq_t *pq)
 {
 	assert(pq);	
 
+	if (NULL == pq->p_q)
+	{
+		return (0 == pq->size);
+	}
+
 	return SortedListIsEmpty(pq->p_q);
 }
 
@@ -77,6 +326,11 @@ void *PriorityQPeek(const pq_t *pq)
 	sliter_t iter = {0};
 	
 	assert(pq);
+
+	if (NULL == pq->p_q)
+	{
+		return (0 == pq->size) ? NULL : pq->heap[0].data;
+	}
 	
 	iter = SortedListPrev(SortedListEnd(pq->p_q));
 
@@ -89,6 +343,13 @@ void PriorityQClear(pq_t *pq)
 	
 	assert(pq);
 
+	if (NULL == pq->p_q)
+	{
+		pq->size = 0;
+
+		return;
+	}
+
 	start = SortedListBegin(pq->p_q);
 	
 	while (!SortedListIsSameIter(start,SortedListEnd(pq->p_q)))
@@ -107,6 +368,36 @@ void PriorityQErase(pq_t *pq, criteria_func_t criteria_func, void *arg)
 
 	assert(pq);
 
+	if (NULL == pq->p_q)
+	{
+		size_t read = 0;
+		size_t write = 0;
+
+		for (read = 0; read < pq->size; ++read)
+		{
+			if (NEED_TO_ERASE != criteria_func(pq->heap[read].data, arg))
+			{
+				pq->heap[write] = pq->heap[read];
+				++write;
+			}
+		}
+
+		pq->size = write;
+
+		for (read = pq->size; 0 < read; --read)
+		{
+			HeapSiftDown(pq, read - 1);
+		}
+
+		/* the filter moved elements without telling */
+		for (read = 0; NULL != pq->set_index && read < pq->size; ++read)
+		{
+			pq->set_index(pq->heap[read].data, read);
+		}
+
+		return;
+	}
+
 	iter_begin = SortedListBegin(pq->p_q);
 	iter_end = SortedListEnd(pq->p_q);
 
@@ -124,3 +415,170 @@ void PriorityQErase(pq_t *pq, criteria_func_t criteria_func, void *arg)
 
 }
 
+void *PriorityQRemoveAt(pq_t *pq, size_t index)
+{
+	void *data = NULL;
+
+	assert(pq);
+	assert(pq->set_index);
+	assert(index < pq->size);
+
+	data = pq->heap[index].data;
+	--pq->size;
+
+	/* the last element fills the hole, it may belong above or below */
+	if (index < pq->size)
+	{
+		HeapPlace(pq, index, pq->heap[pq->size]);
+		HeapSiftUp(pq, index);
+		HeapSiftDown(pq, index);
+	}
+
+	return data;
+}
+
+/*********************************************************************
+					Heap Helper Functions
+*********************************************************************/
+
+/*
+	a leaves the queue before b if the sorted list would keep b in
+	front of a, or if its key is smaller in a keyed queue;
+	equal elements keep their insertion order.
+*/
+static int HeapIsBefore(const pq_t *pq, const heap_entry_t *a,
+												const heap_entry_t *b)
+{
+	int a_prior = 0;
+	int b_prior = 0;
+
+	if (NULL == pq->is_prior)
+	{
+		return (a->key < b->key || (a->key == b->key && a->seq < b->seq));
+	}
+
+	a_prior = pq->is_prior(a->data, b->data);
+	b_prior = pq->is_prior(b->data, a->data);
+
+	if (a_prior != b_prior)
+	{
+		return b_prior;
+	}
+
+	return (a->seq < b->seq);
+}
+
+static void HeapSiftUp(pq_t *pq, size_t index)
+{
+	heap_entry_t entry = pq->heap[index];
+
+	while (0 < index)
+	{
+		size_t parent = (index - 1) / pq->arity;
+
+		if (!HeapIsBefore(pq, &entry, &pq->heap[parent]))
+		{
+			break;
+		}
+
+		HeapPlace(pq, index, pq->heap[parent]);
+		index = parent;
+	}
+
+	HeapPlace(pq, index, entry);
+}
+
+static void HeapSiftDown(pq_t *pq, size_t index)
+{
+	heap_entry_t entry = {0};
+
+	if (index >= pq->size)
+	{
+		return;
+	}
+
+	entry = pq->heap[index];
+
+	for (;;)
+	{
+		size_t first = index * pq->arity + 1;
+		size_t last = first + pq->arity;
+		size_t best = 0;
+		size_t child = 0;
+
+		if (first >= pq->size)
+		{
+			break;
+		}
+
+		if (last > pq->size)
+		{
+			last = pq->size;
+		}
+
+		best = first;
+
+		for (child = first + 1; child < last; ++child)
+		{
+			if (HeapIsBefore(pq, &pq->heap[child], &pq->heap[best]))
+			{
+				best = child;
+			}
+		}
+
+		if (!HeapIsBefore(pq, &pq->heap[best], &entry))
+		{
+			break;
+		}
+
+		HeapPlace(pq, index, pq->heap[best]);
+		index = best;
+	}
+
+	HeapPlace(pq, index, entry);
+}
+
+static int HeapGrow(pq_t *pq)
+{
+	heap_entry_t *heap = (heap_entry_t *)realloc(pq->heap,
+								2 * pq->capacity * sizeof(heap_entry_t));
+
+	if (NULL == heap)
+	{
+		return 1;
+	}
+
+	pq->heap = heap;
+	pq->capacity *= 2;
+	++pq->allocs;
+
+	return 0;
+}
+
+static void HeapPlace(pq_t *pq, size_t index, heap_entry_t entry)
+{
+	pq->heap[index] = entry;
+
+	if (NULL != pq->set_index)
+	{
+		pq->set_index(entry.data, index);
+	}
+}
+
+static int HeapPush(pq_t *pq, void *data, size_t key)
+{
+	if (pq->size == pq->capacity && 0 != HeapGrow(pq))
+	{
+		return 1;
+	}
+
+	pq->heap[pq->size].data = data;
+	pq->heap[pq->size].key = key;
+	pq->heap[pq->size].seq = pq->seq++;
+	++pq->size;
+	pq->high_water = (pq->size > pq->high_water) ? pq->size :
+													pq->high_water;
+	HeapSiftUp(pq, pq->size - 1);
+
+	return 0;
+}
@@ -25,6 +25,18 @@ false otherwise
 */
 typedef int (*criteria_func_t)(const void *data, void *arg); 
 
+/*
+size - elements in the queue.
+high_water - the most elements it held.
+allocs - allocations it made, list nodes or heap array growth.
+*/
+typedef struct
+{
+        size_t size;
+        size_t high_water;
+        size_t allocs;
+} pq_stats_t;
+
 /*
         Create a new priority queue.
         
@@ -37,6 +49,93 @@ typedef int (*criteria_func_t)(const void *data, void *arg);
 */
 pq_t *PriorityQCreate(is_prior_t is_prior);
 
+/*
+        Create a new priority queue backed by a contiguous d-ary heap.
+        All other PriorityQ functions work on it unchanged.
+
+        Arguments:
+                is_prior - function to prioritise by.
+                arity - children per heap node, 0 selects the default (4).
+
+        Elements that compare equal leave the queue in insertion order.
+
+        returns a reference to the new queue, NULL on failure.
+
+        Complexity O(1)
+        Enqueue / Dequeue are O(log n) for this queue.
+*/
+pq_t *PriorityQCreateHeap(is_prior_t is_prior, size_t arity);
+
+/*
+        Create a new list priority queue with nodes taken from arena,
+        Enqueue / Dequeue reuse nodes instead of calling malloc / free.
+
+        Arguments:
+                is_prior - function to prioritise by.
+                arena - must outlive the queue.
+
+        returns a reference to the new queue, NULL on failure.
+
+        Complexity O(1)
+*/
+pq_t *PriorityQCreateFromArena(is_prior_t is_prior, arena_t *arena);
+
+/*
+        Create a new list priority queue of elements that embed a
+        dlink_t, see SortedListCreateIntrusive.
+        Enqueue / Dequeue never allocate and cannot fail.
+
+        Arguments:
+                is_prior - function to prioritise by.
+                link_offset - offsetof the dlink_t in the element's struct.
+
+        returns a reference to the new queue, NULL on failure.
+
+        Complexity O(1)
+*/
+pq_t *PriorityQCreateIntrusive(is_prior_t is_prior, size_t link_offset);
+
+/*
+        Function is called with the new position of data
+        every time a heap queue moves it. Given to
+        PriorityQCreateIndexed or PriorityQCreateKeyed.
+*/
+typedef void (*pq_index_t)(void *data, size_t index);
+
+/*
+        Create a new heap priority queue that reports positions.
+        The user keeps the last index of each element, to remove it
+        with PriorityQRemoveAt without searching for it.
+
+        Arguments:
+                is_prior - function to prioritise by.
+                arity - children per heap node, 0 selects the default (4).
+                set_index - called on every move.
+
+        returns a reference to the new queue, NULL on failure.
+
+        Complexity O(1)
+*/
+pq_t *PriorityQCreateIndexed(is_prior_t is_prior, size_t arity,
+                                                    pq_index_t set_index);
+
+/*
+        Create a new heap priority queue ordered by integer keys.
+        Each element is enqueued with PriorityQEnqueueKeyed, its key is
+        kept in the heap next to it, so ordering neither calls a
+        function nor reads the element. The smallest key leaves first,
+        equal keys leave in insertion order.
+
+        Arguments:
+                arity - children per heap node, 0 selects the default (4).
+                set_index - as in PriorityQCreateIndexed, or NULL.
+
+        returns a reference to the new queue, NULL on failure.
+
+        Complexity O(1)
+*/
+pq_t *PriorityQCreateKeyed(size_t arity, pq_index_t set_index);
+
 /*
         Destroy a given priority queue.
         
@@ -61,6 +160,20 @@ void PriorityQDestroy(pq_t *pq);
 */
 int PriorityQEnqueue(pq_t *pq, void *data);
 
+/*
+        Insert a new element into a keyed queue.
+
+        Arguments:
+                pq - queue made by PriorityQCreateKeyed.
+                data - the data to insert.
+                key - the element's priority, smaller leaves first.
+
+        returns 0 on sucsses, 1 on failure.
+
+        Complexity O(log n)
+*/
+int PriorityQEnqueueKeyed(pq_t *pq, void *data, size_t key);
+
 /*
         Remove the element first in line in a given queue.
         
@@ -80,10 +193,22 @@ void PriorityQDequeue(pq_t *pq);
                 
         returns number of elements.
         
-        Complexity O(n)
+        Complexity O(1)
 */
 size_t PriorityQSize(const pq_t *pq);
 
+/*
+        Fill stats for a given queue, cheap enough to poll
+        from a hot path.
+
+        Arguments:
+                pq - the queue.
+                stats - filled by the function.
+
+        Complexity O(1)
+*/
+void PriorityQStats(const pq_t *pq, pq_stats_t *stats);
+
 /*
         Check if a given queue is empty.
         
@@ -137,4 +262,18 @@ void PriorityQErase(pq_t *pq,
                                         criteria_func_t criteria_func,
                                         void *arg);
 
+/*
+        Remove the element at a given position of an indexed queue.
+
+        Arguments:
+                pq - queue made by PriorityQCreateIndexed, or by
+                        PriorityQCreateKeyed with a set_index.
+                index - last index reported for the element.
+
+        returns the data removed.
+
+        Complexity O(log n)
+*/
+void *PriorityQRemoveAt(pq_t *pq, size_t index);
+
 #endif /* PRIORITY_Q */
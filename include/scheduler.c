@@ -1,60 +1,400 @@
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE (200112L)
+
 #include <stdlib.h>		/* malloc */
+#include <stdio.h>		/* fopen, rename */
+#include <stddef.h>		/* offsetof */
 #include <assert.h>		/* assert */
-#include <time.h>
+#include <errno.h>		/* EINTR */
+#include <time.h>		/* clock_gettime, clock_nanosleep */
+#include <string.h>		/* memset */
+#include <unistd.h>		/* read, close */
+#include <fcntl.h>		/* O_CREAT */
+#include <sys/stat.h>	/* fstat */
+#include <sys/mman.h>	/* shm_open, mmap */
+#include <sys/epoll.h>	/* epoll_create1 */
+#include <sys/timerfd.h>	/* timerfd_create */
+#include <sys/eventfd.h>	/* eventfd */
+#include <sys/syscall.h>	/* SYS_futex */
+#include <linux/futex.h>	/* FUTEX_WAIT_BITSET */
+#include <pthread.h>	/* pthread_create */
+#include <ucontext.h>	/* makecontext, swapcontext */
 
 #include "ilrd_uid.h"   /* ilrd_uid_t */
 #include "priority_q.h" /*priority_q_t*/
+#include "timing_wheel.h" /*twheel_t*/
+#include "uid_table.h"  /*uid_table_t*/
+#include "mpsc_queue.h" /*mpsc_queue_t*/
+#include "arena.h"      /*arena_t*/
+#include "histogram.h"  /*hist_t*/
 #include "scheduler.h"	/*sch_t*/
 
 #define CONTINUE_RUN (0)
+#define NS_IN_SEC (1000000000L)
+#define NS_IN_MS (1000000L)
+#define MS_IN_SEC (1000)
+#define MAX_EVENTS (64)
+#define DEQUE_CAPACITY (64)
+#define DEQUE_RETRY_MS (1)
+#define NODE_TO_TASK(x) ((task_t *)((char *)(x) - offsetof(task_t, node)))
+#define SUBMIT_TO_TASK(x) ((task_t *)((char *)(x) - offsetof(task_t, submit)))
+#define LINK_TO_SUBMIT(x) ((submit_t *)((char *)(x) - offsetof(submit_t, link)))
+#define NEVER ((size_t)-1)
+#define MIN_STACK (8192)
+#define CO_ALIGN (64)
 
 /*********************************************************************
 					Task Functions
 *********************************************************************/
 typedef struct task_s task_t;
 
-static task_t *TaskCreate(size_t interval,opt_t op,void *arg);
+static task_t *TaskCreate(const sch_t *sch, pool_t *pool,
+							const sch_attr_t *attr, opt_t op, void *arg);
 
 static void TaskDestroy(task_t *task);
 
 static int TaskStart(task_t *task);
 
-static void TaskUpdate(task_t *task);
+static void TaskUpdate(task_t *task, const struct timespec *now);
+
+static void TaskSlack(task_t *task);
 
 /*********************************************************************
 					Helper Functions
 *********************************************************************/
-static int IsBefore(const void *data, const void *to_compare);
+static void IndexOp(void *data, size_t index);
+
+static void ClearOp(twnode_t *node, void *arg);
+
+static void SleepCheck(sch_t *sch, int seq,
+									const struct timespec *time_to_run);
+
+static void SchWait(sch_t *sch, size_t limit);
+
+static void RunTask(sch_t *sch, task_t *task, struct timespec *now);
+
+static void RunPass(sch_t *sch, ilrd_uid_t *uid, size_t limit);
+
+static void LoopTake(sch_t *sch);
+
+static void LoopLeave(sch_t *sch);
+
+static void DrainIdle(sch_t *sch);
+
+/*********************************************************************
+					Time Functions
+*********************************************************************/
+static void GetTime(struct timespec *now);
+
+static void SchTime(const sch_t *sch, struct timespec *now);
+
+static void VirtualNow(struct timespec *now, void *arg);
+
+static void VirtualSleep(const struct timespec *deadline, void *arg);
+
+static void TimeAddMs(struct timespec *time, size_t ms);
+
+static int TimeIsBefore(const struct timespec *time,
+									const struct timespec *to_compare);
+
+static size_t TimeToTick(const struct timespec *time);
+
+static struct timespec TickToTime(size_t tick);
+
+static size_t TimeToNs(const struct timespec *time);
+
+static struct timespec NsToTime(size_t ns);
+
+/*********************************************************************
+					Queue Functions
+*********************************************************************/
+static sch_t *SchAlloc(void);
+
+static void SchFree(sch_t *sch);
+
+static int QueuePush(sch_t *sch, task_t *task);
+
+static struct timespec QueueNextDeadline(const sch_t *sch);
+
+static task_t *QueuePopDue(sch_t *sch, const struct timespec *now);
+
+static task_t *LanePopDue(sch_t *sch, size_t lane,
+											const struct timespec *now);
+
+static int QueueIsNext(const sch_t *sch, const task_t *task);
+
+static void QueueRemove(sch_t *sch, task_t *task);
+
+static size_t QueueSize(const sch_t *sch);
+
+static int QueueIsEmpty(const sch_t *sch);
+
+static void QueueClear(sch_t *sch);
+
+/*********************************************************************
+					Reactor Functions
+*********************************************************************/
+typedef struct fd_watch_s fd_watch_t;
+
+static int ReactorInit(sch_t *sch);
+
+static void ReactorClose(sch_t *sch);
+
+static void ReactorWait(sch_t *sch, const struct timespec *deadline);
+
+static void ReactorArm(sch_t *sch, const struct timespec *deadline);
+
+/*********************************************************************
+					Parallel Functions
+*********************************************************************/
+typedef struct worker_s worker_t;
+
+static void SchLock(const sch_t *sch);
+
+static void SchUnlock(const sch_t *sch);
+
+static ilrd_uid_t ParallelRun(sch_t *sch);
+
+static void *WorkerRun(void *arg);
+
+static void WorkerExecute(sch_t *sch, task_t *task);
+
+static int DequePushBack(worker_t *worker, task_t *task);
+
+static task_t *DequePopFront(worker_t *worker);
+
+static task_t *DequePopBack(worker_t *worker);
+
+/*********************************************************************
+					Submission Functions
+*********************************************************************/
+typedef enum
+{
+	SUBMIT_ADD,
+	SUBMIT_REMOVE,
+	SUBMIT_RESCHEDULE,
+	SUBMIT_INTERVAL,
+	SUBMIT_STOP
+} submit_type_t;
+
+/* a request from a thread other than the one in SchRun,
+   an add is the task itself, the others are request_t */
+typedef struct submit_s
+{
+	mpsc_node_t link;
+	submit_type_t type;
+} submit_t;
+
+typedef struct request_s
+{
+	submit_t submit;
+	ilrd_uid_t uid;
+	size_t interval;
+} request_t;
+
+static int IsRemote(const sch_t *sch);
+
+static void Submit(sch_t *sch, submit_t *submit, size_t deadline_ns);
+
+static int SubmitRequest(sch_t *sch, submit_type_t type, ilrd_uid_t uid,
+															size_t interval);
+
+static void Wake(sch_t *sch);
+
+static void WakeSignal(int fd);
+
+static void WakeClear(int fd);
+
+static void Drain(sch_t *sch);
+
+static int AddTask(sch_t *sch, task_t *task);
+
+static void RemoveTask(sch_t *sch, ilrd_uid_t uid);
+
+static int RescheduleTask(sch_t *sch, ilrd_uid_t uid, size_t interval,
+																int restart);
+
+static void StopAll(sch_t *sch);
+
+/*********************************************************************
+					Stats Functions
+*********************************************************************/
+static void StatsRun(sch_t *sch, task_t *task, const struct timespec *start,
+											const struct timespec *end);
+
+static size_t TimeDiffNs(const struct timespec *from,
+										const struct timespec *to);
+
+static void StatsWriteHist(FILE *file, const char *name, const hist_t *hist);
+
+/*********************************************************************
+					Snapshot Functions
+*********************************************************************/
+/*
+	file layout: the header, then count records back to back.
+	Only size_t fields, so there is no padding and the records
+	can be used in place from the mapping.
+*/
+typedef struct snap_header_s
+{
+	size_t magic;
+	size_t version;
+	size_t record_size;
+	size_t count;
+} snap_header_t;
+
+/* times are in ns on the scheduler's clock */
+typedef struct snap_task_s
+{
+	size_t key;
+	size_t interval;
+	size_t time_to_run;
+	size_t period_start;
+	size_t missed;
+	size_t is_late;
+	size_t overrun;
+	size_t max_runtime;
+	size_t stack_size;
+	size_t lane;
+	size_t slack;
+} snap_task_t;
+
+static int SnapCountOp(void *data, void *arg);
+
+static int SnapSaveOp(void *data, void *arg);
+
+static int SnapIsValid(const snap_header_t *header, size_t size);
+
+static int SnapRestore(sch_t *sch, const snap_task_t *record, sch_bind_t bind,
+																void *param);
+
+/*********************************************************************
+					Monitor Functions
+*********************************************************************/
+static void MonitorStart(sch_t *sch);
+
+static void MonitorStop(sch_t *sch);
+
+static int MonitorBegin(sch_t *sch, const task_t *task);
+
+static void MonitorEnd(sch_t *sch, task_t *task, int seq);
+
+static void *MonitorRun(void *arg);
+
+static void SpareRun(sch_t *sch, int seq);
+
+static void LoopRelease(sch_t *sch);
+
+static void LoopReclaim(sch_t *sch);
+
+/*********************************************************************
+					Coroutine Functions
+*********************************************************************/
+typedef struct co_s co_t;
+
+typedef struct stack_class_s stack_class_t;
 
-static int EraseOp(const void *data, void *arg);
+static void CoPrepare(sch_t *sch, task_t *task);
+
+static int CoSwitch(task_t *task);
+
+static void CoFinish(task_t *task);
+
+static void CoEntry(void);
+
+static int CoSuspend(sch_t *sch, size_t ms);
+
+static co_t *StackAlloc(sch_t *sch, size_t size);
+
+static void StackFree(co_t *co);
+
+static void StackRelease(sch_t *sch);
 
-static void SleepCheck(time_t time_to_sleep);
 /*********************************************************************
 					Task Struct and Functions
 *********************************************************************/
+/* a running task is off the queue, a remove meanwhile only marks it
+   and the run drops it once it returns */
+typedef enum
+{
+	TASK_QUEUED,
+	TASK_RUNNING,
+	TASK_CANCELLED
+} task_state_t;
+
 struct task_s
 {
 	size_t interval;
-	time_t time_to_run;
+	struct timespec time_to_run;
+	struct timespec period_start;
+	sch_overrun_t overrun;
+	size_t missed;
+	int is_late;
+	size_t runs;
+	size_t run_ns;
+	size_t max_run_ns;
+	size_t max_late_ns;
+	size_t max_runtime;
+	size_t overruns;
+	size_t stack_size;
+	co_t *co;
+	sch_lane_t lane;
+	size_t key;
+	size_t slack;
 	ilrd_uid_t uid;
 	opt_t op;
 	void *arg;
+	twnode_t node;
+	size_t pq_index;
+	task_state_t state;
+	int restart;
+	size_t stop_gen;
+	submit_t submit;
+	pool_t *pool;
 };
 
-static task_t *TaskCreate(size_t interval,opt_t op,void *arg)
+/* tasks come from the scheduler's pool, other threads use malloc */
+static task_t *TaskCreate(const sch_t *sch, pool_t *pool,
+							const sch_attr_t *attr, opt_t op, void *arg)
 {
-	task_t *task = (task_t *)malloc(sizeof(task_t));
+	task_t *task = (NULL == pool) ? (task_t *)malloc(sizeof(task_t)) :
+													(task_t *)PoolAlloc(pool);
 	
 	if (NULL == task)
 	{
 		return NULL;
 	}
 	
-	task->interval = interval;
-	task->time_to_run =time(NULL) + interval;
+	task->pool = pool;
+	task->interval = attr->interval;
+	SchTime(sch, &task->time_to_run);
+	TimeAddMs(&task->time_to_run, attr->interval);
+	task->period_start = task->time_to_run;
+	task->overrun = attr->overrun;
+	task->missed = 0;
+	task->is_late = 0;
+	task->runs = 0;
+	task->run_ns = 0;
+	task->max_run_ns = 0;
+	task->max_late_ns = 0;
+	task->max_runtime = attr->max_runtime;
+	task->overruns = 0;
+	task->stack_size = attr->stack_size;
+	task->co = NULL;
+	task->lane = attr->lane;
+	task->key = attr->key;
+	task->slack = (attr->slack < attr->interval / 2) ? attr->slack :
+														attr->interval / 2;
 	task->op = op;
 	task->arg = arg;
+	task->node.next = NULL;
+	task->node.prev = NULL;
+	task->pq_index = 0;
+	task->state = TASK_QUEUED;
+	task->restart = 0;
+	task->stop_gen = 0;
 	task->uid = UIDGet();	
+	TaskSlack(task);
 	
 	if (UIDIsBad(task->uid))
 	{
@@ -69,6 +409,19 @@ static task_t *TaskCreate(size_t interval,opt_t op,void *arg)
 static void TaskDestroy(task_t *task)
 {
 	assert(task);
+
+	/* a coroutine dropped while suspended is not unwound */
+	if (NULL != task->co)
+	{
+		StackFree(task->co);
+	}
+
+	if (NULL != task->pool)
+	{
+		PoolFree(task->pool, task);
+
+		return;
+	}
 	
 	free(task);
 	task = NULL;
@@ -81,24 +434,173 @@ static int TaskStart(task_t *task)
 	return task->op(task->arg);
 }
 
-static void TaskUpdate(task_t *task)
-{	
+/* the next deadline is the previous one plus interval, period_start
+   walks that grid while time_to_run may run behind it */
+static void TaskUpdate(task_t *task, const struct timespec *now)
+{
+	size_t behind = 0;
+	size_t ticks = 0;
+
 	assert(task);
-	
-	task->time_to_run = time(NULL) + task->interval;
+	assert(now);
+
+	/* rescheduled while it ran, a new period starts now */
+	if (task->restart)
+	{
+		task->restart = 0;
+		task->is_late = 0;
+		task->period_start = *now;
+		TimeAddMs(&task->period_start, task->interval);
+		task->time_to_run = task->period_start;
+
+		return;
+	}
+
+	/* nothing to anchor, it would be due forever */
+	if (0 == task->interval)
+	{
+		task->time_to_run = *now;
+		task->period_start = *now;
+
+		return;
+	}
+
+	/* a catch up run stood for ticks period_start already went past */
+	if (!task->is_late)
+	{
+		TimeAddMs(&task->period_start, task->interval);
+	}
+
+	task->is_late = 0;
+	task->time_to_run = task->period_start;
+
+	if (TimeIsBefore(now, &task->period_start) || SCH_BURST == task->overrun)
+	{
+		return;
+	}
+
+	/* ticks at period_start, period_start + interval, ... up to now */
+	behind = TimeToNs(now) - TimeToNs(&task->period_start);
+	ticks = behind / (task->interval * NS_IN_MS) + 1;
+
+	if (SCH_SKIP == task->overrun)
+	{
+		task->missed += ticks;
+		TimeAddMs(&task->period_start, ticks * task->interval);
+		task->time_to_run = task->period_start;
+
+		return;
+	}
+
+	/* SCH_CATCH_UP, runs once now, for the latest of the missed ticks */
+	task->missed += ticks - 1;
+	TimeAddMs(&task->time_to_run, (ticks - 1) * task->interval);
+	TimeAddMs(&task->period_start, ticks * task->interval);
+	task->is_late = 1;
+}
+
+/* moves the run to the time in [time_to_run, time_to_run + slack] with
+   the most trailing zero bits. Tasks whose windows overlap mostly land
+   on the same time, and share a wakeup */
+static void TaskSlack(task_t *task)
+{
+	size_t from = TimeToNs(&task->time_to_run);
+	size_t to = from + task->slack * NS_IN_MS;
+	size_t mask = from ^ to;
+
+	if (0 == task->slack)
+	{
+		return;
+	}
+
+	/* the highest bit that differs is set in to, clear the ones below */
+	while (0 != (mask & (mask - 1)))
+	{
+		mask &= mask - 1;
+	}
+
+	task->time_to_run = NsToTime(to & ~(mask - 1));
 }
 
 /*********************************************************************
 					Scheduler Struct and Functions
 *********************************************************************/
+struct fd_watch_s
+{
+	fd_opt_t op;
+	void *arg;
+};
+
+/* per worker deque: the timer pushes at the back, the owner pops the
+   front (earliest deadline first), thieves take from the back */
+struct worker_s
+{
+	pthread_t thread;
+	pthread_mutex_t lock;
+	task_t **tasks;
+	size_t head;
+	size_t count;
+	size_t capacity;
+	size_t id;
+	sch_t *sch;
+};
+
 struct sch_s
 {
-	pq_t *sch;
+	pq_t *sch[SCH_LANES];
+	twheel_t *wheel[SCH_LANES];
+	int lane_weighted;
+	size_t lane_weight[SCH_LANES];
+	size_t lane_credit[SCH_LANES];
+	uid_table_t *tasks;
+	int epoll_fd;
+	int timer_fd;
+	struct timespec armed;
+	fd_watch_t **watches;
+	size_t watch_cap;
+	size_t fd_count;
+	worker_t *workers;
+	size_t nworkers;
+	pthread_mutex_t lock;
+	pthread_cond_t timer_cond;
+	pthread_cond_t work_cond;
+	size_t in_flight;
+	size_t ready;
+	size_t stop_gen;
+	int workers_exit;
+	mpsc_queue_t *submits;
+	pthread_t runner;
+	int has_runner;
+	int in_loop;
+	int wake_seq;
+	size_t sleep_until;
+	int event_fd;
+	int wake_fd;
+	arena_t *arena;
+	pool_t *task_pool;
+	sch_stats_t *stats;
+	int stats_on;
+	pthread_mutex_t run_lock;
+	int loop_free;
+	int want_back;
+	pthread_t monitor;
+	int has_monitor;
+	int monitor_exit;
+	int spare_on;
+	int spare_active;
+	int mon_seq;
+	int mon_idle;
+	int overran_seq;
+	size_t run_deadline;
+	size_t overruns;
+	stack_class_t *stacks;
+	sch_clock_t clock;
 };
 
 sch_t *SchCreate(void)
 {
-	sch_t *sch = (sch_t *)malloc(sizeof(sch_t));
+	sch_t *sch = SchAlloc();
+	size_t lane = 0;
 
 	if (NULL == sch)
 	{
@@ -106,15 +608,102 @@ sch_t *SchCreate(void)
 		return NULL;
 	}
 
-	sch->sch = PriorityQCreate(IsBefore);
+	for (lane = 0; lane < SCH_LANES; ++lane)
+	{
+		sch->sch[lane] = PriorityQCreateKeyed(0, IndexOp);
+
+		if (NULL == sch->sch[lane])
+		{
+			SchFree(sch);
+			
+			return NULL;
+		}
+	}
+	
+	return sch;
+}
+
+sch_t *SchCreateWheel(void)
+{
+	sch_t *sch = SchAlloc();
+	struct timespec now = {0};
+	size_t lane = 0;
 
-	if (NULL == sch->sch)
+	if (NULL == sch)
 	{
-		free(sch);
-		
 		return NULL;
 	}
-	
+
+	GetTime(&now);
+
+	for (lane = 0; lane < SCH_LANES; ++lane)
+	{
+		sch->wheel[lane] = TWheelCreate(TimeToTick(&now));
+
+		if (NULL == sch->wheel[lane])
+		{
+			SchFree(sch);
+
+			return NULL;
+		}
+	}
+
+	return sch;
+}
+
+sch_t *SchCreateParallel(size_t nthreads)
+{
+	sch_t *sch = NULL;
+	pthread_condattr_t attr;
+	size_t i = 0;
+
+	assert(0 < nthreads);
+
+	sch = SchCreate();
+
+	if (NULL == sch)
+	{
+		return NULL;
+	}
+
+	sch->workers = (worker_t *)malloc(nthreads * sizeof(worker_t));
+
+	if (NULL == sch->workers)
+	{
+		SchFree(sch);
+
+		return NULL;
+	}
+
+	/* timed waits follow the same clock as the deadlines */
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_mutex_init(&sch->lock, NULL);
+	pthread_cond_init(&sch->timer_cond, &attr);
+	pthread_cond_init(&sch->work_cond, NULL);
+	pthread_condattr_destroy(&attr);
+
+	for (i = 0; i < nthreads; ++i)
+	{
+		worker_t *worker = &sch->workers[i];
+
+		worker->tasks = (task_t **)malloc(DEQUE_CAPACITY * sizeof(task_t *));
+		worker->head = 0;
+		worker->count = 0;
+		worker->capacity = DEQUE_CAPACITY;
+		worker->id = i;
+		worker->sch = sch;
+		pthread_mutex_init(&worker->lock, NULL);
+		++sch->nworkers;
+
+		if (NULL == worker->tasks)
+		{
+			SchFree(sch);
+
+			return NULL;
+		}
+	}
+
 	return sch;
 }
 
@@ -122,137 +711,2750 @@ void SchDestroy(sch_t *sch)
 {
 	assert(sch);
 	
-	SchStop(sch);
-	PriorityQDestroy(sch->sch);
-	
-	free(sch);
+	Drain(sch);
+	StopAll(sch);
+
+	/* SchRunOnce leaves it running between steps */
+	MonitorStop(sch);
+	SchFree(sch);
 	sch = NULL;
 }
 
-size_t SchSize(const sch_t *sch)
+size_t SchSize(sch_t *sch)
 {
+	size_t size = 0;
+
 	assert(sch);
+
+	DrainIdle(sch);
+	SchLock(sch);
+	size = QueueSize(sch);
+	SchUnlock(sch);
 	
-	return PriorityQSize(sch->sch);
+	return size;
 }
 
-int SchIsEmpty(const sch_t *sch)
+int SchIsEmpty(sch_t *sch)
 {
+	int is_empty = 0;
+
 	assert(sch);
+
+	DrainIdle(sch);
+	SchLock(sch);
+	is_empty = QueueIsEmpty(sch);
+	SchUnlock(sch);
 	
-	return PriorityQIsEmpty(sch->sch);
+	return is_empty;
 }
 
 ilrd_uid_t SchAdd(sch_t *sch, size_t interval, opt_t operation, void *arg)
 {
-	task_t *task = NULL;
-	
-	assert(sch);
-	
-	task = TaskCreate(interval, operation, arg);
-	
-	if (NULL == task)
-	{
-		return UIDGetBad();
-	}
-	
-	PriorityQEnqueue(sch->sch, task);
-	
-	return task->uid;
+	sch_attr_t attr = {0};
+
+	SchAttrInit(&attr, interval);
+
+	return SchAddAttr(sch, &attr, operation, arg);
 }
 
-void SchRemove(sch_t *sch, ilrd_uid_t uid)
+void SchAttrInit(sch_attr_t *attr, size_t interval)
 {
-	assert(sch);
-	
-	PriorityQErase(sch->sch, EraseOp, &uid);
+	assert(attr);
+
+	memset(attr, 0, sizeof(sch_attr_t));
+	attr->interval = interval;
+	attr->overrun = SCH_CATCH_UP;
+	attr->max_runtime = 0;
+	attr->stack_size = 0;
+	attr->lane = SCH_LANE_NORMAL;
+	attr->key = 0;
+	attr->slack = 0;
 }
 
-ilrd_uid_t SchRun(sch_t *sch)
+ilrd_uid_t SchAddAttr(sch_t *sch, const sch_attr_t *attr, opt_t operation,
+																void *arg)
 {
-	int operation_res = 0;
+	task_t *task = NULL;
 	ilrd_uid_t uid = {0};
 	
 	assert(sch);
-	
-	while (!SchIsEmpty(sch))
+	assert(attr);
+
+	if (SCH_LANES <= (size_t)attr->lane)
 	{
-		task_t *task = PriorityQPeek(sch->sch);
-		time_t current_time = time(NULL);
-		
-		PriorityQDequeue(sch->sch);
-		uid = task->uid;
+		return UIDGetBad();
+	}
 
-		if(task->time_to_run >= current_time)
-		{
-			SleepCheck(task->time_to_run - current_time);
-		}
-		
-		operation_res = TaskStart(task);
-		
-		if (CONTINUE_RUN == operation_res)
-		{			
-			TaskUpdate(task);
-			PriorityQEnqueue(sch->sch, task);
-		}
-		else
+	/* the run loop owns the queue and the pool, hand the task over */
+	if (IsRemote(sch))
+	{
+		task = TaskCreate(sch, NULL, attr, operation, arg);
+
+		if (NULL == task)
 		{
-			
-			TaskDestroy(task);
+			return UIDGetBad();
 		}
+
+		uid = task->uid;
+		task->submit.type = SUBMIT_ADD;
+		Submit(sch, &task->submit, TimeToNs(&task->time_to_run));
+
+		return uid;
+	}
+
+	SchLock(sch);
+	
+	task = TaskCreate(sch, sch->task_pool, attr, operation, arg);
+	uid = (NULL == task) ? UIDGetBad() : task->uid;
+
+	if (NULL != task && 0 != AddTask(sch, task))
+	{
+		uid = UIDGetBad();
+	}
+
+	SchUnlock(sch);
 	
+	return uid;
+}
+
+size_t SchMissedTicks(const sch_t *sch, ilrd_uid_t uid)
+{
+	task_t *task = NULL;
+	size_t missed = 0;
+
+	assert(sch);
+
+	SchLock(sch);
+
+	task = (task_t *)UIDTableFind(sch->tasks, uid);
+
+	if (NULL != task)
+	{
+		missed = task->missed;
+	}
+
+	SchUnlock(sch);
+
+	return missed;
+}
+
+int SchYield(sch_t *sch)
+{
+	assert(sch);
+
+	return CoSuspend(sch, 0);
+}
+
+int SchSleepFor(sch_t *sch, size_t ms)
+{
+	assert(sch);
+
+	return CoSuspend(sch, ms);
+}
+
+int SchSetSpare(sch_t *sch, int enable)
+{
+	assert(sch);
+
+	/* workers already run past a stuck task */
+	if (0 < sch->nworkers)
+	{
+		return 1;
+	}
+
+	__atomic_store_n(&sch->spare_on, (0 != enable), __ATOMIC_SEQ_CST);
+
+	return 0;
+}
+
+int SchSetLanes(sch_t *sch, sch_lane_policy_t policy,
+											const size_t weight[SCH_LANES])
+{
+	size_t lane = 0;
+
+	assert(sch);
+
+	if (SCH_LANES_WEIGHTED == policy)
+	{
+		if (NULL == weight)
+		{
+			return 1;
+		}
+
+		for (lane = 0; lane < SCH_LANES; ++lane)
+		{
+			if (0 == weight[lane])
+			{
+				return 1;
+			}
+		}
+	}
+
+	SchLock(sch);
+
+	sch->lane_weighted = (SCH_LANES_WEIGHTED == policy);
+
+	for (lane = 0; lane < SCH_LANES; ++lane)
+	{
+		sch->lane_weight[lane] = (NULL == weight) ? 1 : weight[lane];
+		sch->lane_credit[lane] = sch->lane_weight[lane];
+	}
+
+	SchUnlock(sch);
+
+	return 0;
+}
+
+int SchSetClock(sch_t *sch, const sch_clock_t *clock)
+{
+	twheel_t *wheel[SCH_LANES] = {NULL};
+	sch_clock_t old = {0};
+	struct timespec now = {0};
+	size_t lane = 0;
+
+	assert(sch);
+
+	if (0 < sch->nworkers || -1 != sch->epoll_fd || !QueueIsEmpty(sch) ||
+				(NULL != clock && (NULL == clock->now ||
+				NULL == clock->sleep_until)))
+	{
+		return 1;
+	}
+
+	old = sch->clock;
+	sch->clock.now = (NULL == clock) ? NULL : clock->now;
+	sch->clock.sleep_until = (NULL == clock) ? NULL : clock->sleep_until;
+	sch->clock.arg = (NULL == clock) ? NULL : clock->arg;
+
+	if (NULL == sch->wheel[0])
+	{
+		return 0;
+	}
+
+	/* the wheels count ticks from the time they were made */
+	SchTime(sch, &now);
+
+	for (lane = 0; lane < SCH_LANES; ++lane)
+	{
+		wheel[lane] = TWheelCreate(TimeToTick(&now));
+
+		if (NULL == wheel[lane])
+		{
+			while (0 < lane)
+			{
+				TWheelDestroy(wheel[--lane]);
+			}
+
+			sch->clock = old;
+
+			return 1;
+		}
+	}
+
+	for (lane = 0; lane < SCH_LANES; ++lane)
+	{
+		TWheelDestroy(sch->wheel[lane]);
+		sch->wheel[lane] = wheel[lane];
+	}
+
+	return 0;
+}
+
+void SchVirtualClock(sch_clock_t *clock, struct timespec *now)
+{
+	assert(clock);
+	assert(now);
+
+	clock->now = VirtualNow;
+	clock->sleep_until = VirtualSleep;
+	clock->arg = now;
+}
+
+void SchNow(const sch_t *sch, struct timespec *now)
+{
+	assert(sch);
+	assert(now);
+
+	SchTime(sch, now);
+}
+
+int SchSave(const sch_t *sch, const char *path)
+{
+	snap_header_t *header = NULL;
+	snap_task_t *next = NULL;
+	char *tmp_path = NULL;
+	size_t count = 0;
+	size_t size = 0;
+	int status = 0;
+	int fd = -1;
+
+	assert(sch);
+	assert(path);
+
+	/* deadlines on a custom clock mean nothing to another process */
+	if (IsRemote(sch) || NULL != sch->clock.now)
+	{
+		return 1;
+	}
+
+	tmp_path = (char *)malloc(strlen(path) + sizeof(".tmp"));
+
+	if (NULL == tmp_path)
+	{
+		return 1;
+	}
+
+	strcpy(tmp_path, path);
+	strcat(tmp_path, ".tmp");
+	SchLock(sch);
+
+	UIDTableForEach(sch->tasks, SnapCountOp, &count);
+	size = sizeof(snap_header_t) + count * sizeof(snap_task_t);
+	fd = open(tmp_path, O_CREAT | O_RDWR | O_TRUNC, 0644);
+	status = (-1 == fd || 0 != ftruncate(fd, (off_t)size));
+
+	if (0 == status)
+	{
+		header = (snap_header_t *)mmap(NULL, size, PROT_READ | PROT_WRITE,
+														MAP_SHARED, fd, 0);
+		status = (MAP_FAILED == (void *)header);
+	}
+
+	if (0 == status)
+	{
+		header->magic = SCH_SNAP_MAGIC;
+		header->version = SCH_SNAP_VERSION;
+		header->record_size = sizeof(snap_task_t);
+		header->count = count;
+		next = (snap_task_t *)(header + 1);
+		UIDTableForEach(sch->tasks, SnapSaveOp, &next);
+		munmap(header, size);
+	}
+
+	SchUnlock(sch);
+
+	if (-1 != fd)
+	{
+		status = (0 != close(fd)) || status;
+	}
+
+	if (0 == status)
+	{
+		status = rename(tmp_path, path);
+	}
+	else
+	{
+		remove(tmp_path);
+	}
+
+	free(tmp_path);
+
+	return status;
+}
+
+int SchLoad(sch_t *sch, const char *path, sch_bind_t bind, void *param)
+{
+	const snap_header_t *header = NULL;
+	const snap_task_t *record = NULL;
+	struct stat info;
+	size_t i = 0;
+	int status = 0;
+	int fd = -1;
+
+	assert(sch);
+	assert(path);
+	assert(bind);
+
+	/* saved deadlines are CLOCK_MONOTONIC times */
+	if (IsRemote(sch) || NULL != sch->clock.now)
+	{
+		return 1;
+	}
+
+	fd = open(path, O_RDONLY);
+
+	if (-1 == fd)
+	{
+		return 1;
+	}
+
+	if (0 != fstat(fd, &info) ||
+						(size_t)info.st_size < sizeof(snap_header_t))
+	{
+		close(fd);
+
+		return 1;
+	}
+
+	header = (const snap_header_t *)mmap(NULL, (size_t)info.st_size,
+												PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (MAP_FAILED == (const void *)header)
+	{
+		return 1;
+	}
+
+	status = !SnapIsValid(header, (size_t)info.st_size);
+	record = (const snap_task_t *)(header + 1);
+	SchLock(sch);
+
+	for (i = 0; 0 == status && i < header->count; ++i)
+	{
+		status = SnapRestore(sch, &record[i], bind, param);
+	}
+
+	SchUnlock(sch);
+	munmap((void *)header, (size_t)info.st_size);
+
+	return status;
+}
+
+size_t SchOverruns(const sch_t *sch)
+{
+	assert(sch);
+
+	return __atomic_load_n(&sch->overruns, __ATOMIC_SEQ_CST);
+}
+
+int SchSetStats(sch_t *sch, int enable)
+{
+	int status = 0;
+
+	assert(sch);
+
+	SchLock(sch);
+
+	if (enable && NULL == sch->stats)
+	{
+		sch->stats = (sch_stats_t *)malloc(sizeof(sch_stats_t));
+	}
+
+	if (enable && NULL == sch->stats)
+	{
+		status = 1;
+	}
+	else if (enable)
+	{
+		memset(sch->stats, 0, sizeof(sch_stats_t));
+		HistInit(&sch->stats->lateness);
+		HistInit(&sch->stats->runtime);
+		HistInit(&sch->stats->queue_depth);
+	}
+
+	sch->stats_on = (0 == status && enable);
+
+	SchUnlock(sch);
+
+	return status;
+}
+
+int SchGetStats(const sch_t *sch, sch_stats_t *stats)
+{
+	int status = 1;
+
+	assert(sch);
+	assert(stats);
+
+	SchLock(sch);
+
+	if (sch->stats_on)
+	{
+		*stats = *sch->stats;
+		stats->tasks = UIDTableSize(sch->tasks);
+		status = 0;
+	}
+
+	SchUnlock(sch);
+
+	return status;
+}
+
+int SchGetTaskStats(const sch_t *sch, ilrd_uid_t uid,
+												sch_task_stats_t *stats)
+{
+	task_t *task = NULL;
+
+	assert(sch);
+	assert(stats);
+
+	SchLock(sch);
+
+	task = (task_t *)UIDTableFind(sch->tasks, uid);
+
+	if (NULL != task)
+	{
+		stats->runs = task->runs;
+		stats->total_ns = task->run_ns;
+		stats->max_ns = task->max_run_ns;
+		stats->max_late_ns = task->max_late_ns;
+		stats->missed = task->missed;
+		stats->overruns = task->overruns;
+	}
+
+	SchUnlock(sch);
+
+	return (NULL == task);
+}
+
+int SchStatsExport(const sch_stats_t *stats, const char *path)
+{
+	char *tmp_path = NULL;
+	FILE *file = NULL;
+	int status = 0;
+
+	assert(stats);
+	assert(path);
+
+	tmp_path = (char *)malloc(strlen(path) + sizeof(".tmp"));
+
+	if (NULL == tmp_path)
+	{
+		return 1;
+	}
+
+	strcpy(tmp_path, path);
+	strcat(tmp_path, ".tmp");
+	file = fopen(tmp_path, "w");
+
+	if (NULL == file)
+	{
+		free(tmp_path);
+
+		return 1;
+	}
+
+	fprintf(file, "runs %lu\n", (unsigned long)stats->runs);
+	fprintf(file, "tasks %lu\n", (unsigned long)stats->tasks);
+	fprintf(file, "longest_ns %lu\n", (unsigned long)stats->longest_ns);
+	fprintf(file, "longest_uid %ld.%06ld-%d-%lu\n",
+			(long)stats->longest_uid.time.tv_sec,
+			(long)stats->longest_uid.time.tv_usec,
+			(int)stats->longest_uid.pid,
+			(unsigned long)stats->longest_uid.counter);
+	StatsWriteHist(file, "lateness_ns", &stats->lateness);
+	StatsWriteHist(file, "runtime_ns", &stats->runtime);
+	StatsWriteHist(file, "queue_depth", &stats->queue_depth);
+
+	status = ferror(file);
+	status = (0 != fclose(file)) || status;
+
+	if (0 == status)
+	{
+		status = rename(tmp_path, path);
+	}
+	else
+	{
+		remove(tmp_path);
+	}
+
+	free(tmp_path);
+
+	return (0 != status);
+}
+
+int SchStatsExportShm(const sch_stats_t *stats, const char *name)
+{
+	sch_stats_shm_t *shm = NULL;
+	int fd = -1;
+
+	assert(stats);
+	assert(name);
+
+	fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+
+	if (-1 == fd)
+	{
+		return 1;
+	}
+
+	if (0 != ftruncate(fd, sizeof(sch_stats_shm_t)))
+	{
+		close(fd);
+
+		return 1;
+	}
+
+	shm = (sch_stats_shm_t *)mmap(NULL, sizeof(sch_stats_shm_t),
+								PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (MAP_FAILED == (void *)shm)
+	{
+		return 1;
+	}
+
+	/* seqlock, readers retry while seq is odd or changed under them */
+	shm->magic = SCH_STATS_MAGIC;
+	shm->version = SCH_STATS_VERSION;
+	__atomic_store_n(&shm->seq, (shm->seq | 1), __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	shm->stats = *stats;
+	__atomic_store_n(&shm->seq, shm->seq + 1, __ATOMIC_RELEASE);
+
+	munmap(shm, sizeof(sch_stats_shm_t));
+
+	return 0;
+}
+
+int SchRemove(sch_t *sch, ilrd_uid_t uid)
+{
+	assert(sch);
+
+	if (IsRemote(sch))
+	{
+		return SubmitRequest(sch, SUBMIT_REMOVE, uid, 0);
+	}
+
+	RemoveTask(sch, uid);
+
+	return 0;
+}
+
+int SchReschedule(sch_t *sch, ilrd_uid_t uid, size_t interval)
+{
+	assert(sch);
+
+	if (IsRemote(sch))
+	{
+		return SubmitRequest(sch, SUBMIT_RESCHEDULE, uid, interval);
+	}
+
+	return RescheduleTask(sch, uid, interval, 1);
+}
+
+int SchSetInterval(sch_t *sch, ilrd_uid_t uid, size_t interval)
+{
+	assert(sch);
+
+	if (IsRemote(sch))
+	{
+		return SubmitRequest(sch, SUBMIT_INTERVAL, uid, interval);
+	}
+
+	return RescheduleTask(sch, uid, interval, 0);
+}
+
+ilrd_uid_t SchRun(sch_t *sch)
+{
+	ilrd_uid_t uid = {0};
+	
+	assert(sch);
+
+	if (0 < sch->nworkers)
+	{
+		return ParallelRun(sch);
+	}
+
+	LoopTake(sch);
+	
+	while (!QueueIsEmpty(sch) || 0 < sch->fd_count)
+	{
+		RunPass(sch, &uid, NEVER);
+	}
+
+	LoopLeave(sch);
+	MonitorStop(sch);
+	
+	return uid;
+}
+
+size_t SchRunOnce(sch_t *sch)
+{
+	ilrd_uid_t uid = {0};
+	struct timespec now = {0};
+	struct timespec next = {0};
+	size_t wait_ms = SCH_NO_DEADLINE;
+
+	assert(sch);
+
+	if (0 < sch->nworkers)
+	{
+		return SCH_NO_DEADLINE;
+	}
+
+	LoopTake(sch);
+	WakeClear(sch->wake_fd);
+	RunPass(sch, &uid, 0);
+
+	if (!QueueIsEmpty(sch))
+	{
+		next = QueueNextDeadline(sch);
+		SchTime(sch, &now);
+
+		/* rounded up, a host that sleeps this long finds the task due */
+		wait_ms = TimeIsBefore(&now, &next) ?
+				(TimeDiffNs(&now, &next) + NS_IN_MS - 1) / NS_IN_MS : 0;
+	}
+
+	/* the host sleeps until then, requests that need it sooner
+	   signal the wake fd. Published before the last drain, so
+	   nothing slips in between */
+	if (-1 != sch->wake_fd)
+	{
+		__atomic_store_n(&sch->sleep_until, (SCH_NO_DEADLINE == wait_ms) ?
+							NEVER : TimeToNs(&next), __ATOMIC_SEQ_CST);
+	}
+
+	LoopLeave(sch);
+
+	return wait_ms;
+}
+
+int SchWakeFd(sch_t *sch)
+{
+	assert(sch);
+
+	if (0 < sch->nworkers)
+	{
+		return -1;
+	}
+
+	if (-1 == sch->wake_fd)
+	{
+		__atomic_store_n(&sch->wake_fd, eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC),
+															__ATOMIC_SEQ_CST);
+	}
+
+	return sch->wake_fd;
+}
+
+ilrd_uid_t SchRunUntil(sch_t *sch, const struct timespec *deadline)
+{
+	ilrd_uid_t uid = UIDGetBad();
+	struct timespec now = {0};
+	size_t limit = 0;
+
+	assert(sch);
+	assert(deadline);
+
+	if (0 < sch->nworkers)
+	{
+		return uid;
+	}
+
+	/* 0 would mean a pass that does not wait */
+	limit = TimeToNs(deadline);
+	limit = (0 == limit) ? 1 : limit;
+
+	LoopTake(sch);
+	SchTime(sch, &now);
+
+	while ((!QueueIsEmpty(sch) || 0 < sch->fd_count) &&
+												TimeIsBefore(&now, deadline))
+	{
+		RunPass(sch, &uid, limit);
+		SchTime(sch, &now);
+	}
+
+	LoopLeave(sch);
+	MonitorStop(sch);
+
+	return uid;
+}
+
+int SchAddFd(sch_t *sch, int fd, unsigned int events, fd_opt_t operation,
+																void *arg)
+{
+	struct epoll_event event = {0};
+	fd_watch_t *watch = NULL;
+
+	assert(sch);
+	assert(operation);
+
+	/* the reactor runs on a single thread, on the real clock */
+	if (0 > fd || 0 < sch->nworkers || NULL != sch->clock.now ||
+						(-1 == sch->epoll_fd && 0 != ReactorInit(sch)))
+	{
+		return 1;
+	}
+
+	if ((size_t)fd >= sch->watch_cap)
+	{
+		size_t cap = 2 * (size_t)fd + 1;
+		fd_watch_t **watches = (fd_watch_t **)realloc(sch->watches,
+												cap * sizeof(fd_watch_t *));
+
+		if (NULL == watches)
+		{
+			return 1;
+		}
+
+		memset(watches + sch->watch_cap, 0,
+							(cap - sch->watch_cap) * sizeof(fd_watch_t *));
+		sch->watches = watches;
+		sch->watch_cap = cap;
+	}
+
+	if (NULL != sch->watches[fd])
+	{
+		return 1;
+	}
+
+	watch = (fd_watch_t *)malloc(sizeof(fd_watch_t));
+
+	if (NULL == watch)
+	{
+		return 1;
+	}
+
+	watch->op = operation;
+	watch->arg = arg;
+	event.events = events;
+	event.data.fd = fd;
+
+	if (0 != epoll_ctl(sch->epoll_fd, EPOLL_CTL_ADD, fd, &event))
+	{
+		free(watch);
+
+		return 1;
+	}
+
+	sch->watches[fd] = watch;
+	++sch->fd_count;
+
+	return 0;
+}
+
+void SchRemoveFd(sch_t *sch, int fd)
+{
+	struct epoll_event event = {0};
+
+	assert(sch);
+
+	if (0 > fd || (size_t)fd >= sch->watch_cap || NULL == sch->watches[fd])
+	{
+		return;
+	}
+
+	/* may fail if fd was already closed, the watch goes anyway */
+	epoll_ctl(sch->epoll_fd, EPOLL_CTL_DEL, fd, &event);
+
+	free(sch->watches[fd]);
+	sch->watches[fd] = NULL;
+	--sch->fd_count;
+}
+
+int SchStop(sch_t *sch)
+{
+	assert(sch);
+
+	if (IsRemote(sch))
+	{
+		return SubmitRequest(sch, SUBMIT_STOP, UIDGetBad(), 0);
+	}
+
+	StopAll(sch);
+
+	return 0;
+}
+
+/*********************************************************************
+					Helper Functions
+*********************************************************************/
+
+static void StopAll(sch_t *sch)
+{
+	if (0 < sch->fd_count)
+	{
+		size_t fd = 0;
+
+		for (fd = 0; fd < sch->watch_cap; ++fd)
+		{
+			SchRemoveFd(sch, (int)fd);
+		}
+	}
+
+	SchLock(sch);
+
+	/* dispatched tasks are dropped when a worker gets to them */
+	++sch->stop_gen;
+	QueueClear(sch);
+
+	if (0 < sch->nworkers)
+	{
+		pthread_cond_signal(&sch->timer_cond);
+	}
+
+	SchUnlock(sch);
+}
+
+/* the heap reports moves, so removing a task needs no search */
+static void IndexOp(void *data, size_t index)
+{
+	((task_t *)data)->pq_index = index;
+}
+
+static void ClearOp(twnode_t *node, void *arg)
+{
+	sch_t *sch = (sch_t *)arg;
+	task_t *task = NODE_TO_TASK(node);
+
+	UIDTableRemove(sch->tasks, task->uid);
+	TaskDestroy(task);
+}
+
+/* a futex wait is a sleep that Wake can cut short,
+   FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC deadline */
+static void SleepCheck(sch_t *sch, int seq,
+									const struct timespec *time_to_run)
+{
+    while (-1 == syscall(SYS_futex, &sch->wake_seq, FUTEX_WAIT_BITSET, seq,
+                        time_to_run, NULL, FUTEX_BITSET_MATCH_ANY) &&
+                                                            EINTR == errno)
+    {
+    }
+}
+
+/* sleeps until the next deadline, or until limit if that comes first */
+static void SchWait(sch_t *sch, size_t limit)
+{
+	struct timespec time_to_run = {0};
+	int seq = __atomic_load_n(&sch->wake_seq, __ATOMIC_SEQ_CST);
+	size_t sleep_until = NEVER;
+
+	if (!QueueIsEmpty(sch))
+	{
+		time_to_run = QueueNextDeadline(sch);
+		sleep_until = TimeToNs(&time_to_run);
+	}
+
+	if (limit < sleep_until)
+	{
+		time_to_run = NsToTime(limit);
+		sleep_until = limit;
+	}
+
+	/* publish the deadline, then look for requests that missed it */
+	__atomic_store_n(&sch->sleep_until, sleep_until, __ATOMIC_SEQ_CST);
+
+	/* want_back is read after seq, a runner asking back is not missed */
+	if (MPSCQueueIsEmpty(sch->submits) &&
+							!__atomic_load_n(&sch->want_back, __ATOMIC_SEQ_CST))
+	{
+		if (-1 != sch->epoll_fd)
+		{
+			/* a limit of 0 polls the fds without blocking */
+			ReactorWait(sch, (NEVER == sleep_until) ? NULL : &time_to_run);
+		}
+		else if (0 != limit && NULL != sch->clock.sleep_until &&
+													NEVER != sleep_until)
+		{
+			sch->clock.sleep_until(&time_to_run, sch->clock.arg);
+		}
+		else if (0 != limit)
+		{
+			/* only the spare waits on an empty queue, for a wake up */
+			SleepCheck(sch, seq, (NEVER == sleep_until) ? NULL : &time_to_run);
+		}
+	}
+
+	__atomic_store_n(&sch->sleep_until, 0, __ATOMIC_SEQ_CST);
+}
+
+/* leaves the time the run ended in now */
+static void RunTask(sch_t *sch, task_t *task, struct timespec *now)
+{
+	int operation_res = 0;
+	int stats_on = sch->stats_on;
+	int monitored = (0 != task->max_runtime && !sch->spare_active);
+	int hand_over = 0;
+	int cancelled = 0;
+	int seq = 0;
+	struct timespec start = {0};
+	struct timespec end = {0};
+
+	task->state = TASK_RUNNING;
+	task->stop_gen = sch->stop_gen;
+
+	if (0 != task->stack_size)
+	{
+		CoPrepare(sch, task);
+	}
+
+	if (stats_on)
+	{
+		SchTime(sch, &start);
+	}
+
+	if (monitored)
+	{
+		MonitorStart(sch);
+		seq = MonitorBegin(sch, task);
+		hand_over = sch->has_monitor &&
+							__atomic_load_n(&sch->spare_on, __ATOMIC_SEQ_CST);
+	}
+
+	/* while it runs the spare may take the loop */
+	if (hand_over)
+	{
+		LoopRelease(sch);
+	}
+
+	operation_res = (0 == task->stack_size) ? TaskStart(task) : CoSwitch(task);
+
+	if (monitored)
+	{
+		MonitorEnd(sch, task, seq);
+	}
+
+	if (hand_over)
+	{
+		LoopReclaim(sch);
+	}
+
+	CoFinish(task);
+	cancelled = (TASK_CANCELLED == task->state);
+	task->state = TASK_QUEUED;
+
+	/* the next deadline needs the end time anyway,
+	   so stats add only the read at the start */
+	SchTime(sch, &end);
+	*now = end;
+
+	if (stats_on && sch->stats_on)
+	{
+		StatsRun(sch, task, &start, &end);
+	}
+
+	/* a task that stopped the scheduler or was removed is not queued
+	   again, a suspended coroutine already set when it resumes */
+	if (CONTINUE_RUN == operation_res && task->stop_gen == sch->stop_gen &&
+																!cancelled)
+	{
+		if (NULL == task->co)
+		{
+			TaskUpdate(task, &end);
+			TaskSlack(task);
+		}
+
+		if (0 == QueuePush(sch, task))
+		{
+			return;
+		}
+	}
+
+	UIDTableRemove(sch->tasks, task->uid);
+	TaskDestroy(task);
+}
+
+/* one turn of the loop: wait, apply submissions, run what is due.
+   The wait ends at limit at the latest, 0 does not wait */
+static void RunPass(sch_t *sch, ilrd_uid_t *uid, size_t limit)
+{
+	task_t *task = NULL;
+	struct timespec current_time = {0};
+	size_t runs = 0;
+
+	SchWait(sch, limit);
+	Drain(sch);
+	SchTime(sch, &current_time);
+	runs = QueueSize(sch);
+
+	if (sch->stats_on)
+	{
+		HistRecord(&sch->stats->queue_depth, QueueSize(sch));
+	}
+
+	/* what is due runs before the next wait. Each pick sees the clock
+	   after the last run, so a higher lane falling due meanwhile goes
+	   first, and a pass runs at most one round of the queue */
+	task = QueuePopDue(sch, &current_time);
+
+	while (NULL != task)
+	{
+		*uid = task->uid;
+		RunTask(sch, task, &current_time);
+		task = (0 < --runs) ? QueuePopDue(sch, &current_time) : NULL;
+	}
+
+	Drain(sch);
+}
+
+/* the loop belongs to whoever holds run_lock, the spare takes it
+   while a task overruns, from here other threads go through the
+   submission queue */
+static void LoopTake(sch_t *sch)
+{
+	pthread_mutex_lock(&sch->run_lock);
+	__atomic_store_n(&sch->runner, pthread_self(), __ATOMIC_SEQ_CST);
+	__atomic_store_n(&sch->loop_free, 0, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&sch->has_runner, 1, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&sch->in_loop, 1, __ATOMIC_SEQ_CST);
+	Drain(sch);
+}
+
+/* the owner stays, later requests still queue and wait for DrainIdle
+   or the next run */
+static void LoopLeave(sch_t *sch)
+{
+	Drain(sch);
+	__atomic_store_n(&sch->in_loop, 0, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock(&sch->run_lock);
+}
+
+/* the owner, outside a run, applies what other threads queued since */
+static void DrainIdle(sch_t *sch)
+{
+	if (!IsRemote(sch) && __atomic_load_n(&sch->has_runner, __ATOMIC_SEQ_CST)
+						&& !__atomic_load_n(&sch->in_loop, __ATOMIC_SEQ_CST))
+	{
+		pthread_mutex_lock(&sch->run_lock);
+		Drain(sch);
+		pthread_mutex_unlock(&sch->run_lock);
+	}
+}
+
+/*********************************************************************
+					Queue Functions
+*********************************************************************/
+
+static sch_t *SchAlloc(void)
+{
+	sch_t *sch = (sch_t *)malloc(sizeof(sch_t));
+	size_t lane = 0;
+
+	if (NULL == sch)
+	{
+		return NULL;
+	}
+
+	for (lane = 0; lane < SCH_LANES; ++lane)
+	{
+		sch->sch[lane] = NULL;
+		sch->wheel[lane] = NULL;
+		sch->lane_weight[lane] = 1;
+		sch->lane_credit[lane] = 1;
+	}
+
+	sch->lane_weighted = 0;
+	sch->epoll_fd = -1;
+	sch->timer_fd = -1;
+	sch->watches = NULL;
+	sch->watch_cap = 0;
+	sch->fd_count = 0;
+	sch->workers = NULL;
+	sch->nworkers = 0;
+	sch->in_flight = 0;
+	sch->ready = 0;
+	sch->stop_gen = 0;
+	sch->workers_exit = 0;
+	sch->has_runner = 0;
+	sch->in_loop = 0;
+	sch->wake_seq = 0;
+	sch->sleep_until = 0;
+	sch->event_fd = -1;
+	sch->wake_fd = -1;
+	sch->stats = NULL;
+	sch->stats_on = 0;
+	sch->loop_free = 0;
+	sch->want_back = 0;
+	sch->has_monitor = 0;
+	sch->monitor_exit = 0;
+	sch->spare_on = 0;
+	sch->spare_active = 0;
+	sch->mon_seq = 0;
+	sch->mon_idle = 0;
+	sch->overran_seq = 0;
+	sch->run_deadline = NEVER;
+	sch->overruns = 0;
+	sch->stacks = NULL;
+	sch->clock.now = NULL;
+	sch->clock.sleep_until = NULL;
+	sch->clock.arg = NULL;
+	sch->submits = MPSCQueueCreate();
+	sch->tasks = UIDTableCreate(0);
+	sch->arena = ArenaCreate(0);
+	sch->task_pool = (NULL == sch->arena) ? NULL :
+									PoolCreate(sch->arena, sizeof(task_t));
+
+	if (NULL == sch->tasks || NULL == sch->submits || NULL == sch->task_pool ||
+								0 != pthread_mutex_init(&sch->run_lock, NULL))
+	{
+		if (NULL != sch->submits)
+		{
+			MPSCQueueDestroy(sch->submits);
+		}
+
+		if (NULL != sch->tasks)
+		{
+			UIDTableDestroy(sch->tasks);
+		}
+
+		if (NULL != sch->arena)
+		{
+			ArenaDestroy(sch->arena);
+		}
+
+		free(sch);
+
+		return NULL;
+	}
+
+	return sch;
+}
+
+static void SchFree(sch_t *sch)
+{
+	size_t lane = 0;
+
+	for (lane = 0; lane < SCH_LANES; ++lane)
+	{
+		if (NULL != sch->sch[lane])
+		{
+			PriorityQDestroy(sch->sch[lane]);
+		}
+
+		if (NULL != sch->wheel[lane])
+		{
+			TWheelDestroy(sch->wheel[lane]);
+		}
+	}
+
+	if (NULL != sch->workers)
+	{
+		size_t i = 0;
+
+		for (i = 0; i < sch->nworkers; ++i)
+		{
+			pthread_mutex_destroy(&sch->workers[i].lock);
+			free(sch->workers[i].tasks);
+		}
+
+		pthread_cond_destroy(&sch->work_cond);
+		pthread_cond_destroy(&sch->timer_cond);
+		pthread_mutex_destroy(&sch->lock);
+		free(sch->workers);
+	}
+
+	ReactorClose(sch);
+
+	if (-1 != sch->wake_fd)
+	{
+		close(sch->wake_fd);
+	}
+
+	MPSCQueueDestroy(sch->submits);
+	UIDTableDestroy(sch->tasks);
+	pthread_mutex_destroy(&sch->run_lock);
+
+	/* every pooled task goes at once, stack classes live there too */
+	StackRelease(sch);
+	ArenaDestroy(sch->arena);
+	free(sch->stats);
+	free(sch);
+}
+
+static int QueuePush(sch_t *sch, task_t *task)
+{
+	if (NULL != sch->wheel[0])
+	{
+		/* rounded up, so no task fires early */
+		TWheelAdd(sch->wheel[task->lane], &task->node,
+							TimeToTick(&task->time_to_run) +
+							(0 != task->time_to_run.tv_nsec % NS_IN_MS));
+
+		return 0;
+	}
+
+	/* the deadline is the key, the heap compares it without a call */
+	return PriorityQEnqueueKeyed(sch->sch[task->lane], task,
+												TimeToNs(&task->time_to_run));
+}
+
+/* earliest deadline over the lanes, the queue is not empty */
+static struct timespec QueueNextDeadline(const sch_t *sch)
+{
+	struct timespec next = {0};
+	struct timespec time_to_run = {0};
+	int found = 0;
+	size_t lane = 0;
+
+	for (lane = 0; lane < SCH_LANES; ++lane)
+	{
+		if (NULL != sch->wheel[0])
+		{
+			if (0 == TWheelSize(sch->wheel[lane]))
+			{
+				continue;
+			}
+
+			time_to_run = TickToTime(TWheelNextExpiry(sch->wheel[lane]));
+		}
+		else
+		{
+			if (PriorityQIsEmpty(sch->sch[lane]))
+			{
+				continue;
+			}
+
+			time_to_run = ((task_t *)PriorityQPeek(sch->sch[lane]))->
+																time_to_run;
+		}
+
+		if (!found || TimeIsBefore(&time_to_run, &next))
+		{
+			next = time_to_run;
+			found = 1;
+		}
+	}
+
+	return next;
+}
+
+/*
+	strict: the first lane with a due task.
+	weighted: each lane spends a credit per task, lanes out of credit
+	wait until no lane with credit has a task due, then all refill.
+*/
+static task_t *QueuePopDue(sch_t *sch, const struct timespec *now)
+{
+	task_t *task = NULL;
+	size_t lane = 0;
+	int refill = 0;
+
+	for (refill = 0; refill < 2; ++refill)
+	{
+		for (lane = 0; lane < SCH_LANES; ++lane)
+		{
+			if (sch->lane_weighted && 0 == sch->lane_credit[lane])
+			{
+				continue;
+			}
+
+			task = LanePopDue(sch, lane, now);
+
+			if (NULL != task)
+			{
+				sch->lane_credit[lane] -= sch->lane_weighted;
+
+				return task;
+			}
+		}
+
+		if (!sch->lane_weighted)
+		{
+			return NULL;
+		}
+
+		for (lane = 0; lane < SCH_LANES; ++lane)
+		{
+			sch->lane_credit[lane] = sch->lane_weight[lane];
+		}
+	}
+
+	return NULL;
+}
+
+static task_t *LanePopDue(sch_t *sch, size_t lane,
+											const struct timespec *now)
+{
+	task_t *task = NULL;
+
+	if (NULL != sch->wheel[0])
+	{
+		twnode_t *node = TWheelExpire(sch->wheel[lane], TimeToTick(now));
+
+		return (NULL == node) ? NULL : NODE_TO_TASK(node);
+	}
+
+	task = PriorityQPeek(sch->sch[lane]);
+
+	if (NULL == task || TimeIsBefore(now, &task->time_to_run))
+	{
+		return NULL;
+	}
+
+	PriorityQDequeue(sch->sch[lane]);
+
+	return task;
+}
+
+/* a task queued ahead of every other deadline */
+static int QueueIsNext(const sch_t *sch, const task_t *task)
+{
+	struct timespec next = QueueNextDeadline(sch);
+
+	return !TimeIsBefore(&next, &task->time_to_run);
+}
+
+static void QueueRemove(sch_t *sch, task_t *task)
+{
+	if (NULL != sch->wheel[0])
+	{
+		TWheelRemove(sch->wheel[task->lane], &task->node);
+
+		return;
+	}
+
+	PriorityQRemoveAt(sch->sch[task->lane], task->pq_index);
+}
+
+static size_t QueueSize(const sch_t *sch)
+{
+	size_t size = 0;
+	size_t lane = 0;
+
+	for (lane = 0; lane < SCH_LANES; ++lane)
+	{
+		size += (NULL != sch->wheel[0]) ? TWheelSize(sch->wheel[lane]) :
+											PriorityQSize(sch->sch[lane]);
+	}
+
+	return size;
+}
+
+static int QueueIsEmpty(const sch_t *sch)
+{
+	return (0 == QueueSize(sch));
+}
+
+static void QueueClear(sch_t *sch)
+{
+	size_t lane = 0;
+
+	for (lane = 0; lane < SCH_LANES; ++lane)
+	{
+		if (NULL != sch->wheel[0])
+		{
+			TWheelClear(sch->wheel[lane], ClearOp, sch);
+
+			continue;
+		}
+
+		while (!PriorityQIsEmpty(sch->sch[lane]))
+		{
+			task_t *task = PriorityQPeek(sch->sch[lane]);
+			PriorityQDequeue(sch->sch[lane]);
+			UIDTableRemove(sch->tasks, task->uid);
+			TaskDestroy(task);
+		}
+	}
+}
+
+/*********************************************************************
+					Stats Functions
+*********************************************************************/
+
+/* called before TaskUpdate, time_to_run is still this run's deadline */
+static void StatsRun(sch_t *sch, task_t *task, const struct timespec *start,
+											const struct timespec *end)
+{
+	sch_stats_t *stats = sch->stats;
+	size_t late_ns = TimeDiffNs(&task->time_to_run, start);
+	size_t run_ns = TimeDiffNs(start, end);
+
+	++stats->runs;
+	HistRecord(&stats->lateness, late_ns);
+	HistRecord(&stats->runtime, run_ns);
+
+	if (run_ns > stats->longest_ns)
+	{
+		stats->longest_ns = run_ns;
+		stats->longest_uid = task->uid;
+	}
+
+	++task->runs;
+	task->run_ns += run_ns;
+
+	if (run_ns > task->max_run_ns)
+	{
+		task->max_run_ns = run_ns;
+	}
+
+	if (late_ns > task->max_late_ns)
+	{
+		task->max_late_ns = late_ns;
+	}
+}
+
+/* 0 if to is not after from */
+static size_t TimeDiffNs(const struct timespec *from,
+										const struct timespec *to)
+{
+	size_t from_ns = TimeToNs(from);
+	size_t to_ns = TimeToNs(to);
+
+	return (to_ns > from_ns) ? to_ns - from_ns : 0;
+}
+
+static void StatsWriteHist(FILE *file, const char *name, const hist_t *hist)
+{
+	fprintf(file, "%s_count %lu\n", name, (unsigned long)hist->count);
+	fprintf(file, "%s_min %lu\n", name,
+					(unsigned long)((0 == hist->count) ? 0 : hist->min));
+	fprintf(file, "%s_mean %lu\n", name, (unsigned long)((0 == hist->count) ?
+											0 : hist->sum / hist->count));
+	fprintf(file, "%s_p50 %lu\n", name,
+								(unsigned long)HistPercentile(hist, 50));
+	fprintf(file, "%s_p90 %lu\n", name,
+								(unsigned long)HistPercentile(hist, 90));
+	fprintf(file, "%s_p99 %lu\n", name,
+								(unsigned long)HistPercentile(hist, 99));
+	fprintf(file, "%s_p999 %lu\n", name,
+								(unsigned long)HistPercentile(hist, 99.9));
+	fprintf(file, "%s_max %lu\n", name, (unsigned long)hist->max);
+}
+
+/*********************************************************************
+					Snapshot Functions
+*********************************************************************/
+/* tasks with no key have no way back to their operation */
+static int SnapCountOp(void *data, void *arg)
+{
+	*(size_t *)arg += (0 != ((task_t *)data)->key);
+
+	return 0;
+}
+
+static int SnapSaveOp(void *data, void *arg)
+{
+	const task_t *task = (const task_t *)data;
+	snap_task_t **next = (snap_task_t **)arg;
+	snap_task_t *record = *next;
+
+	if (0 == task->key)
+	{
+		return 0;
+	}
+
+	record->key = task->key;
+	record->interval = task->interval;
+	record->time_to_run = TimeToNs(&task->time_to_run);
+	record->period_start = TimeToNs(&task->period_start);
+	record->missed = task->missed;
+	record->is_late = (size_t)task->is_late;
+	record->overrun = (size_t)task->overrun;
+	record->max_runtime = task->max_runtime;
+	record->stack_size = task->stack_size;
+	record->lane = (size_t)task->lane;
+	record->slack = task->slack;
+	++*next;
+
+	return 0;
+}
+
+static int SnapIsValid(const snap_header_t *header, size_t size)
+{
+	return (SCH_SNAP_MAGIC == header->magic &&
+			SCH_SNAP_VERSION == header->version &&
+			sizeof(snap_task_t) == header->record_size &&
+			header->count <= (size - sizeof(snap_header_t)) /
+												sizeof(snap_task_t));
+}
+
+/* a task bind turns down is skipped, not an error */
+static int SnapRestore(sch_t *sch, const snap_task_t *record, sch_bind_t bind,
+																void *param)
+{
+	sch_attr_t attr;
+	task_t *task = NULL;
+	opt_t operation = NULL;
+	void *arg = NULL;
+
+	if (SCH_LANES <= record->lane || SCH_BURST < record->overrun)
+	{
+		return 1;
+	}
+
+	if (0 != bind(record->key, &operation, &arg, param) || NULL == operation)
+	{
+		return 0;
+	}
+
+	SchAttrInit(&attr, record->interval);
+	attr.overrun = (sch_overrun_t)record->overrun;
+	attr.max_runtime = record->max_runtime;
+	attr.stack_size = record->stack_size;
+	attr.lane = (sch_lane_t)record->lane;
+	attr.key = record->key;
+	attr.slack = record->slack;
+
+	task = TaskCreate(sch, sch->task_pool, &attr, operation, arg);
+
+	if (NULL == task)
+	{
+		return 1;
+	}
+
+	task->time_to_run = NsToTime(record->time_to_run);
+	task->period_start = NsToTime(record->period_start);
+	task->missed = record->missed;
+	task->is_late = (0 != record->is_late);
+
+	return AddTask(sch, task);
+}
+
+/*********************************************************************
+					Monitor Functions
+*********************************************************************/
+
+/* started by the first run of a task with a max runtime */
+static void MonitorStart(sch_t *sch)
+{
+	if (sch->has_monitor)
+	{
+		return;
+	}
+
+	__atomic_store_n(&sch->monitor_exit, 0, __ATOMIC_SEQ_CST);
+	sch->has_monitor = (0 == pthread_create(&sch->monitor, NULL,
+														MonitorRun, sch));
+}
+
+/* the caller has let go of run_lock, a spare waiting for it gives up */
+static void MonitorStop(sch_t *sch)
+{
+	if (!sch->has_monitor)
+	{
+		return;
+	}
+
+	__atomic_store_n(&sch->monitor_exit, 1, __ATOMIC_SEQ_CST);
+	__atomic_add_fetch(&sch->mon_seq, 2, __ATOMIC_SEQ_CST);
+	syscall(SYS_futex, &sch->mon_seq, FUTEX_WAKE, 1, NULL, NULL, 0);
+	pthread_join(sch->monitor, NULL);
+	sch->has_monitor = 0;
+}
+
+/* mon_seq is odd while a watched task runs, the monitor is only woken
+   when it sleeps with nothing to watch */
+static int MonitorBegin(sch_t *sch, const task_t *task)
+{
+	struct timespec deadline = {0};
+	int seq = 0;
+
+	GetTime(&deadline);
+	TimeAddMs(&deadline, task->max_runtime);
+	__atomic_store_n(&sch->run_deadline, TimeToNs(&deadline),
+															__ATOMIC_SEQ_CST);
+	seq = __atomic_add_fetch(&sch->mon_seq, 1, __ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&sch->mon_idle, __ATOMIC_SEQ_CST))
+	{
+		syscall(SYS_futex, &sch->mon_seq, FUTEX_WAKE, 1, NULL, NULL, 0);
+	}
+
+	return seq;
+}
+
+static void MonitorEnd(sch_t *sch, task_t *task, int seq)
+{
+	__atomic_store_n(&sch->run_deadline, NEVER, __ATOMIC_SEQ_CST);
+	__atomic_add_fetch(&sch->mon_seq, 1, __ATOMIC_SEQ_CST);
+
+	/* the monitor never touches the task, it may be gone by now */
+	if (seq == __atomic_load_n(&sch->overran_seq, __ATOMIC_SEQ_CST))
+	{
+		++task->overruns;
+	}
+}
+
+static void *MonitorRun(void *arg)
+{
+	sch_t *sch = (sch_t *)arg;
+	int flagged = 0;
+
+	while (!__atomic_load_n(&sch->monitor_exit, __ATOMIC_SEQ_CST))
+	{
+		int seq = __atomic_load_n(&sch->mon_seq, __ATOMIC_SEQ_CST);
+		size_t deadline = __atomic_load_n(&sch->run_deadline, __ATOMIC_SEQ_CST);
+		struct timespec now = {0};
+
+		/* nothing running, or this run was already flagged */
+		if (0 == (seq & 1) || seq == flagged || NEVER == deadline)
+		{
+			__atomic_store_n(&sch->mon_idle, 1, __ATOMIC_SEQ_CST);
+			syscall(SYS_futex, &sch->mon_seq, FUTEX_WAIT, seq, NULL, NULL, 0);
+			__atomic_store_n(&sch->mon_idle, 0, __ATOMIC_SEQ_CST);
+
+			continue;
+		}
+
+		now.tv_sec = (time_t)(deadline / NS_IN_SEC);
+		now.tv_nsec = (long)(deadline % NS_IN_SEC);
+		syscall(SYS_futex, &sch->mon_seq, FUTEX_WAIT_BITSET, seq, &now, NULL,
+													FUTEX_BITSET_MATCH_ANY);
+		GetTime(&now);
+
+		if (seq != __atomic_load_n(&sch->mon_seq, __ATOMIC_SEQ_CST) ||
+												TimeToNs(&now) < deadline)
+		{
+			continue;
+		}
+
+		flagged = seq;
+		__atomic_store_n(&sch->overran_seq, seq, __ATOMIC_SEQ_CST);
+		__atomic_add_fetch(&sch->overruns, 1, __ATOMIC_SEQ_CST);
+
+		if (__atomic_load_n(&sch->spare_on, __ATOMIC_SEQ_CST))
+		{
+			SpareRun(sch, seq);
+		}
+	}
+
+	return NULL;
+}
+
+/* runs the other tasks until the stuck one returns, its own tasks are
+   not watched */
+static void SpareRun(sch_t *sch, int seq)
+{
+	ilrd_uid_t uid = {0};
+
+	pthread_mutex_lock(&sch->run_lock);
+
+	/* the runner may have come back while the lock was awaited */
+	if (seq != __atomic_load_n(&sch->mon_seq, __ATOMIC_SEQ_CST) ||
+						__atomic_load_n(&sch->monitor_exit, __ATOMIC_SEQ_CST))
+	{
+		pthread_mutex_unlock(&sch->run_lock);
+
+		return;
+	}
+
+	__atomic_store_n(&sch->runner, pthread_self(), __ATOMIC_SEQ_CST);
+	__atomic_store_n(&sch->loop_free, 0, __ATOMIC_SEQ_CST);
+	sch->spare_active = 1;
+	Drain(sch);
+
+	while (!__atomic_load_n(&sch->want_back, __ATOMIC_SEQ_CST) &&
+						!__atomic_load_n(&sch->monitor_exit, __ATOMIC_SEQ_CST))
+	{
+		RunPass(sch, &uid, NEVER);
+	}
+
+	sch->spare_active = 0;
+	__atomic_store_n(&sch->loop_free, 1, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock(&sch->run_lock);
+}
+
+/* calls made while nobody holds the loop are queued, by the task too */
+static void LoopRelease(sch_t *sch)
+{
+	__atomic_store_n(&sch->loop_free, 1, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock(&sch->run_lock);
+}
+
+static void LoopReclaim(sch_t *sch)
+{
+	__atomic_store_n(&sch->want_back, 1, __ATOMIC_SEQ_CST);
+	Wake(sch);
+	pthread_mutex_lock(&sch->run_lock);
+	__atomic_store_n(&sch->want_back, 0, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&sch->runner, pthread_self(), __ATOMIC_SEQ_CST);
+	__atomic_store_n(&sch->loop_free, 0, __ATOMIC_SEQ_CST);
+}
+
+/*********************************************************************
+					Coroutine Functions
+*********************************************************************/
+
+/* the context sits at the top of its stack mapping, a guard page
+   below the stack catches overflows */
+struct co_s
+{
+	ucontext_t context;
+	ucontext_t caller;
+	int result;
+	int is_done;
+	co_t *next_free;
+	stack_class_t *bucket;
+	char *base;
+	size_t map_size;
+};
+
+/* stacks of one size, kept for reuse */
+struct stack_class_s
+{
+	size_t size;
+	co_t *free;
+	stack_class_t *next;
+};
+
+/* the task being run on this thread, SchYield suspends it */
+static __thread task_t *g_current_task = NULL;
+
+/* the caller holds the loop, or the lock in parallel mode */
+static void CoPrepare(sch_t *sch, task_t *task)
+{
+	co_t *co = NULL;
+
+	if (NULL != task->co)
+	{
+		return;
+	}
+
+	co = StackAlloc(sch, task->stack_size);
+
+	/* no stack, the run is skipped and tried next period */
+	if (NULL == co)
+	{
+		return;
+	}
+
+	getcontext(&co->context);
+	co->context.uc_stack.ss_sp = co->base + sysconf(_SC_PAGESIZE);
+	co->context.uc_stack.ss_size = (size_t)((char *)co -
+										(char *)co->context.uc_stack.ss_sp);
+	co->context.uc_link = &co->caller;
+	makecontext(&co->context, CoEntry, 0);
+	co->is_done = 0;
+	task->co = co;
+}
+
+/* runs the coroutine until it returns or suspends */
+static int CoSwitch(task_t *task)
+{
+	task_t *outer = g_current_task;
+
+	if (NULL == task->co)
+	{
+		return CONTINUE_RUN;
+	}
+
+	g_current_task = task;
+	swapcontext(&task->co->caller, &task->co->context);
+	g_current_task = outer;
+
+	return task->co->is_done ? task->co->result : CONTINUE_RUN;
+}
+
+/* gives back the stack of a coroutine that returned */
+static void CoFinish(task_t *task)
+{
+	if (NULL != task->co && task->co->is_done)
+	{
+		StackFree(task->co);
+		task->co = NULL;
+	}
+}
+
+/* returning switches to uc_link, the last CoSwitch */
+static void CoEntry(void)
+{
+	task_t *task = g_current_task;
+
+	task->co->result = task->op(task->arg);
+	task->co->is_done = 1;
+}
+
+static int CoSuspend(sch_t *sch, size_t ms)
+{
+	task_t *task = g_current_task;
+
+	if (NULL == task || NULL == task->co)
+	{
+		return 1;
+	}
+
+	SchTime(sch, &task->time_to_run);
+	TimeAddMs(&task->time_to_run, ms);
+	swapcontext(&task->co->context, &task->co->caller);
+
+	return 0;
+}
+
+static co_t *StackAlloc(sch_t *sch, size_t size)
+{
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	size_t co_size = (sizeof(co_t) + CO_ALIGN - 1) & ~(size_t)(CO_ALIGN - 1);
+	stack_class_t *bucket = sch->stacks;
+	co_t *co = NULL;
+	char *base = NULL;
+	size_t map_size = 0;
+
+	size = (size < MIN_STACK) ? MIN_STACK : size;
+	size = (size + page - 1) & ~(page - 1);
+
+	while (NULL != bucket && bucket->size != size)
+	{
+		bucket = bucket->next;
+	}
+
+	if (NULL == bucket)
+	{
+		bucket = (stack_class_t *)ArenaAlloc(sch->arena, sizeof(stack_class_t));
+
+		if (NULL == bucket)
+		{
+			return NULL;
+		}
+
+		bucket->size = size;
+		bucket->free = NULL;
+		bucket->next = sch->stacks;
+		sch->stacks = bucket;
+	}
+
+	if (NULL != bucket->free)
+	{
+		co = bucket->free;
+		bucket->free = co->next_free;
+
+		return co;
+	}
+
+	map_size = (page + size + co_size + page - 1) & ~(page - 1);
+	base = (char *)mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+								MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+
+	if (MAP_FAILED == (void *)base)
+	{
+		return NULL;
+	}
+
+	if (0 != mprotect(base, page, PROT_NONE))
+	{
+		munmap(base, map_size);
+
+		return NULL;
+	}
+
+	co = (co_t *)(base + map_size - co_size);
+	co->bucket = bucket;
+	co->base = base;
+	co->map_size = map_size;
+
+	return co;
+}
+
+static void StackFree(co_t *co)
+{
+	co->next_free = co->bucket->free;
+	co->bucket->free = co;
+}
+
+static void StackRelease(sch_t *sch)
+{
+	stack_class_t *bucket = NULL;
+
+	for (bucket = sch->stacks; NULL != bucket; bucket = bucket->next)
+	{
+		while (NULL != bucket->free)
+		{
+			co_t *co = bucket->free;
+
+			bucket->free = co->next_free;
+			munmap(co->base, co->map_size);
+		}
+	}
+
+	sch->stacks = NULL;
+}
+
+/*********************************************************************
+					Time Functions
+*********************************************************************/
+
+static void GetTime(struct timespec *now)
+{
+	clock_gettime(CLOCK_MONOTONIC, now);
+}
+
+/* task deadlines are on the scheduler's clock,
+   run times watched by the monitor stay on the real one */
+static void SchTime(const sch_t *sch, struct timespec *now)
+{
+	if (NULL != sch->clock.now)
+	{
+		sch->clock.now(now, sch->clock.arg);
+
+		return;
+	}
+
+	GetTime(now);
+}
+
+static void VirtualNow(struct timespec *now, void *arg)
+{
+	*now = *(const struct timespec *)arg;
+}
+
+/* nothing else runs meanwhile, so the wait is over at once */
+static void VirtualSleep(const struct timespec *deadline, void *arg)
+{
+	struct timespec *now = (struct timespec *)arg;
+
+	if (TimeIsBefore(now, deadline))
+	{
+		*now = *deadline;
+	}
+}
+
+static void TimeAddMs(struct timespec *time, size_t ms)
+{
+	time->tv_sec += ms / MS_IN_SEC;
+	time->tv_nsec += (long)(ms % MS_IN_SEC) * NS_IN_MS;
+
+	if (NS_IN_SEC <= time->tv_nsec)
+	{
+		time->tv_nsec -= NS_IN_SEC;
+		++time->tv_sec;
+	}
+}
+
+static int TimeIsBefore(const struct timespec *time,
+									const struct timespec *to_compare)
+{
+	return (time->tv_sec < to_compare->tv_sec ||
+			(time->tv_sec == to_compare->tv_sec &&
+							time->tv_nsec < to_compare->tv_nsec));
+}
+
+/* wheel ticks are milliseconds */
+static size_t TimeToTick(const struct timespec *time)
+{
+	return (size_t)time->tv_sec * MS_IN_SEC + (size_t)(time->tv_nsec / NS_IN_MS);
+}
+
+static struct timespec TickToTime(size_t tick)
+{
+	struct timespec time = {0};
+
+	time.tv_sec = (time_t)(tick / MS_IN_SEC);
+	time.tv_nsec = (long)(tick % MS_IN_SEC) * NS_IN_MS;
+
+	return time;
+}
+
+static size_t TimeToNs(const struct timespec *time)
+{
+	return (size_t)time->tv_sec * NS_IN_SEC + (size_t)time->tv_nsec;
+}
+
+static struct timespec NsToTime(size_t ns)
+{
+	struct timespec time = {0};
+
+	time.tv_sec = (time_t)(ns / NS_IN_SEC);
+	time.tv_nsec = (long)(ns % NS_IN_SEC);
+
+	return time;
+}
+
+/*********************************************************************
+					Reactor Functions
+*********************************************************************/
+
+static int ReactorInit(sch_t *sch)
+{
+	struct epoll_event event = {0};
+
+	sch->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	sch->timer_fd = timerfd_create(CLOCK_MONOTONIC,
+											TFD_NONBLOCK | TFD_CLOEXEC);
+
+	event.events = EPOLLIN;
+	event.data.fd = sch->timer_fd;
+
+	if (-1 == sch->epoll_fd || -1 == sch->timer_fd ||
+			0 != epoll_ctl(sch->epoll_fd, EPOLL_CTL_ADD, sch->timer_fd, &event))
+	{
+		ReactorClose(sch);
+
+		return 1;
+	}
+
+	/* Wake writes here once the loop sleeps in epoll_wait */
+	event.data.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (-1 == event.data.fd ||
+			0 != epoll_ctl(sch->epoll_fd, EPOLL_CTL_ADD, event.data.fd, &event))
+	{
+		if (-1 != event.data.fd)
+		{
+			close(event.data.fd);
+		}
+
+		ReactorClose(sch);
+
+		return 1;
+	}
+
+	__atomic_store_n(&sch->event_fd, event.data.fd, __ATOMIC_SEQ_CST);
+
+	sch->armed.tv_sec = 0;
+	sch->armed.tv_nsec = 0;
+
+	return 0;
+}
+
+static void ReactorClose(sch_t *sch)
+{
+	if (-1 != sch->timer_fd)
+	{
+		close(sch->timer_fd);
+	}
+
+	if (-1 != sch->epoll_fd)
+	{
+		close(sch->epoll_fd);
+	}
+
+	if (-1 != sch->event_fd)
+	{
+		close(sch->event_fd);
+	}
+
+	free(sch->watches);
+
+	sch->timer_fd = -1;
+	sch->epoll_fd = -1;
+	sch->event_fd = -1;
+	sch->watches = NULL;
+	sch->watch_cap = 0;
+}
+
+/* one timerfd always armed to the earliest deadline, zero when disarmed */
+/* NULL disarms */
+static void ReactorArm(sch_t *sch, const struct timespec *deadline)
+{
+	struct itimerspec spec = {{0}, {0}};
+
+	if (NULL != deadline)
+	{
+		spec.it_value = *deadline;
+
+		/* a zero it_value would disarm instead */
+		if (0 == spec.it_value.tv_sec && 0 == spec.it_value.tv_nsec)
+		{
+			spec.it_value.tv_nsec = 1;
+		}
+	}
+
+	if (spec.it_value.tv_sec == sch->armed.tv_sec &&
+								spec.it_value.tv_nsec == sch->armed.tv_nsec)
+	{
+		return;
+	}
+
+	timerfd_settime(sch->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL);
+	sch->armed = spec.it_value;
+}
+
+static void ReactorWait(sch_t *sch, const struct timespec *deadline)
+{
+	struct epoll_event events[MAX_EVENTS];
+	int count = 0;
+	int i = 0;
+
+	ReactorArm(sch, deadline);
+
+	count = epoll_wait(sch->epoll_fd, events, MAX_EVENTS, -1);
+
+	for (i = 0; i < count; ++i)
+	{
+		int fd = events[i].data.fd;
+		fd_watch_t *watch = NULL;
+
+		if (fd == sch->timer_fd)
+		{
+			unsigned long expirations = 0;
+
+			/* fired timers disarm themselves */
+			if (0 < read(fd, &expirations, sizeof(expirations)))
+			{
+				sch->armed.tv_sec = 0;
+				sch->armed.tv_nsec = 0;
+			}
+
+			continue;
+		}
+
+		if (fd == sch->event_fd)
+		{
+			WakeClear(fd);
+
+			continue;
+		}
+
+		/* an earlier callback in this batch may have removed it */
+		if ((size_t)fd >= sch->watch_cap || NULL == sch->watches[fd])
+		{
+			continue;
+		}
+
+		watch = sch->watches[fd];
+
+		if (CONTINUE_RUN != watch->op(fd, events[i].events, watch->arg))
+		{
+			SchRemoveFd(sch, fd);
+		}
+	}
+}
+
+/*********************************************************************
+					Parallel Functions
+*********************************************************************/
+
+static void SchLock(const sch_t *sch)
+{
+	if (0 < sch->nworkers)
+	{
+		pthread_mutex_lock((pthread_mutex_t *)&sch->lock);
+	}
+}
+
+static void SchUnlock(const sch_t *sch)
+{
+	if (0 < sch->nworkers)
+	{
+		pthread_mutex_unlock((pthread_mutex_t *)&sch->lock);
+	}
+}
+
+/* the calling thread is the timer thread, it only moves due tasks */
+static ilrd_uid_t ParallelRun(sch_t *sch)
+{
+	ilrd_uid_t uid = {0};
+	size_t started = 0;
+	size_t next_worker = 0;
+	size_t tried = 0;
+
+	sch->workers_exit = 0;
+
+	for (started = 0; started < sch->nworkers; ++started)
+	{
+		if (0 != pthread_create(&sch->workers[started].thread, NULL,
+										WorkerRun, &sch->workers[started]))
+		{
+			break;
+		}
 	}
-	
+
+	pthread_mutex_lock(&sch->lock);
+
+	while (0 < started && (!QueueIsEmpty(sch) || 0 < sch->in_flight))
+	{
+		struct timespec current_time = {0};
+		struct timespec time_to_run = {0};
+		task_t *task = NULL;
+
+		if (QueueIsEmpty(sch))
+		{
+			pthread_cond_wait(&sch->timer_cond, &sch->lock);
+			continue;
+		}
+
+		time_to_run = QueueNextDeadline(sch);
+		GetTime(&current_time);
+
+		if (TimeIsBefore(&current_time, &time_to_run))
+		{
+			pthread_cond_timedwait(&sch->timer_cond, &sch->lock, &time_to_run);
+			continue;
+		}
+
+		if (sch->stats_on)
+		{
+			HistRecord(&sch->stats->queue_depth, QueueSize(sch));
+		}
+
+		task = QueuePopDue(sch, &current_time);
+
+		while (NULL != task)
+		{
+			uid = task->uid;
+			task->state = TASK_RUNNING;
+			task->stop_gen = sch->stop_gen;
+			++sch->in_flight;
+			++sch->ready;
+
+			for (tried = 0; tried < started &&
+					0 != DequePushBack(&sch->workers[next_worker], task); ++tried)
+			{
+				next_worker = (next_worker + 1) % started;
+			}
+
+			if (tried == started)
+			{
+				/* every deque refused it, requeue and let the workers
+				   drain before the next attempt */
+				struct timespec retry_at = current_time;
+
+				task->state = TASK_QUEUED;
+				--sch->in_flight;
+				--sch->ready;
+				QueuePush(sch, task);
+				pthread_cond_broadcast(&sch->work_cond);
+				TimeAddMs(&retry_at, DEQUE_RETRY_MS);
+				pthread_cond_timedwait(&sch->timer_cond, &sch->lock, &retry_at);
+				break;
+			}
+
+			next_worker = (next_worker + 1) % started;
+			pthread_cond_signal(&sch->work_cond);
+			task = QueuePopDue(sch, &current_time);
+		}
+	}
+
+	sch->workers_exit = 1;
+	pthread_cond_broadcast(&sch->work_cond);
+	pthread_mutex_unlock(&sch->lock);
+
+	while (0 < started)
+	{
+		--started;
+		pthread_join(sch->workers[started].thread, NULL);
+	}
+
 	return uid;
 }
 
-void SchStop(sch_t *sch)
+/* own deque first, then steal, sleep when all are empty */
+static void *WorkerRun(void *arg)
 {
-	assert(sch);
-	
-	while (!SchIsEmpty(sch))
+	worker_t *self = (worker_t *)arg;
+	sch_t *sch = self->sch;
+
+	for (;;)
 	{
-		task_t *task = PriorityQPeek(sch->sch);
-		PriorityQDequeue(sch->sch);
-		TaskDestroy(task);
+		task_t *task = DequePopFront(self);
+		size_t i = 0;
+
+		for (i = 1; NULL == task && i < sch->nworkers; ++i)
+		{
+			task = DequePopBack(&sch->workers[(self->id + i) % sch->nworkers]);
+		}
+
+		if (NULL != task)
+		{
+			WorkerExecute(sch, task);
+			continue;
+		}
+
+		pthread_mutex_lock(&sch->lock);
+
+		while (0 == sch->ready && !sch->workers_exit)
+		{
+			pthread_cond_wait(&sch->work_cond, &sch->lock);
+		}
+
+		if (0 == sch->ready && sch->workers_exit)
+		{
+			pthread_mutex_unlock(&sch->lock);
+
+			return NULL;
+		}
+
+		pthread_mutex_unlock(&sch->lock);
 	}
-	
+}
+
+/* runs outside the lock, re-enqueues under it */
+static void WorkerExecute(sch_t *sch, task_t *task)
+{
+	int operation_res = !CONTINUE_RUN;
+	size_t stop_gen = 0;
+	int stats_on = 0;
+	int run = 0;
+	int ran = 0;
+	struct timespec start = {0};
+	struct timespec end = {0};
+
+	pthread_mutex_lock(&sch->lock);
+	--sch->ready;
+	stop_gen = sch->stop_gen;
+	stats_on = sch->stats_on;
+
+	/* removed or stopped since it was dispatched */
+	run = (task->stop_gen == stop_gen && TASK_CANCELLED != task->state);
+
+	if (0 != task->stack_size && run)
+	{
+		CoPrepare(sch, task);
+	}
+
+	pthread_mutex_unlock(&sch->lock);
+
+	if (run)
+	{
+		if (stats_on || 0 != task->max_runtime)
+		{
+			GetTime(&start);
+		}
+
+		operation_res = (0 == task->stack_size) ? TaskStart(task) :
+															CoSwitch(task);
+		ran = 1;
+		GetTime(&end);
+	}
+
+	pthread_mutex_lock(&sch->lock);
+
+	CoFinish(task);
+	run = (TASK_CANCELLED != task->state);
+	task->state = TASK_QUEUED;
+	--sch->in_flight;
+
+	if (ran && stats_on && sch->stats_on)
+	{
+		StatsRun(sch, task, &start, &end);
+	}
+
+	/* a worker is only counted after the fact, the others kept going */
+	if (ran && 0 != task->max_runtime &&
+					TimeDiffNs(&start, &end) > task->max_runtime * NS_IN_MS)
+	{
+		++task->overruns;
+		__atomic_add_fetch(&sch->overruns, 1, __ATOMIC_SEQ_CST);
+	}
+
+	if (CONTINUE_RUN == operation_res && task->stop_gen == sch->stop_gen &&
+																		run)
+	{
+		if (NULL == task->co)
+		{
+			TaskUpdate(task, &end);
+			TaskSlack(task);
+		}
+
+		if (0 == QueuePush(sch, task))
+		{
+			if (QueueIsNext(sch, task))
+			{
+				pthread_cond_signal(&sch->timer_cond);
+			}
+
+			pthread_mutex_unlock(&sch->lock);
+
+			return;
+		}
+	}
+
+	UIDTableRemove(sch->tasks, task->uid);
+
+	TaskDestroy(task);
+
+	if (0 == sch->in_flight)
+	{
+		pthread_cond_signal(&sch->timer_cond);
+	}
+
+	pthread_mutex_unlock(&sch->lock);
+}
+
+static int DequePushBack(worker_t *worker, task_t *task)
+{
+	pthread_mutex_lock(&worker->lock);
+
+	if (worker->count == worker->capacity)
+	{
+		size_t capacity = 2 * worker->capacity;
+		task_t **tasks = (task_t **)malloc(capacity * sizeof(task_t *));
+		size_t i = 0;
+
+		if (NULL == tasks)
+		{
+			pthread_mutex_unlock(&worker->lock);
+
+			return 1;
+		}
+
+		for (i = 0; i < worker->count; ++i)
+		{
+			tasks[i] = worker->tasks[(worker->head + i) % worker->capacity];
+		}
+
+		free(worker->tasks);
+		worker->tasks = tasks;
+		worker->head = 0;
+		worker->capacity = capacity;
+	}
+
+	worker->tasks[(worker->head + worker->count) % worker->capacity] = task;
+	++worker->count;
+
+	pthread_mutex_unlock(&worker->lock);
+
+	return 0;
+}
+
+static task_t *DequePopFront(worker_t *worker)
+{
+	task_t *task = NULL;
+
+	pthread_mutex_lock(&worker->lock);
+
+	if (0 < worker->count)
+	{
+		task = worker->tasks[worker->head];
+		worker->head = (worker->head + 1) % worker->capacity;
+		--worker->count;
+	}
+
+	pthread_mutex_unlock(&worker->lock);
+
+	return task;
+}
+
+static task_t *DequePopBack(worker_t *worker)
+{
+	task_t *task = NULL;
+
+	pthread_mutex_lock(&worker->lock);
+
+	if (0 < worker->count)
+	{
+		--worker->count;
+		task = worker->tasks[(worker->head + worker->count) % worker->capacity];
+	}
+
+	pthread_mutex_unlock(&worker->lock);
+
+	return task;
 }
 
 /*********************************************************************
-					Helper Functions
+					Submission Functions
 *********************************************************************/
 
-static int EraseOp(const void *data, void *arg)
+static int IsRemote(const sch_t *sch)
 {
-	ilrd_uid_t remove_uid = *(ilrd_uid_t *)arg;
-	task_t *task = (task_t *)data;
-	
-	if (UIDIsSame(remove_uid, task->uid))
+	return (__atomic_load_n(&sch->has_runner, __ATOMIC_SEQ_CST) &&
+			(__atomic_load_n(&sch->loop_free, __ATOMIC_SEQ_CST) ||
+			!pthread_equal(__atomic_load_n(&sch->runner, __ATOMIC_SEQ_CST),
+														pthread_self())));
+}
+
+/* wakes the loop only if it sleeps past deadline_ns */
+static void Submit(sch_t *sch, submit_t *submit, size_t deadline_ns)
+{
+	MPSCQueuePush(sch->submits, &submit->link);
+
+	if (deadline_ns < __atomic_load_n(&sch->sleep_until, __ATOMIC_SEQ_CST))
+	{
+		Wake(sch);
+	}
+}
+
+static int SubmitRequest(sch_t *sch, submit_type_t type, ilrd_uid_t uid,
+															size_t interval)
+{
+	request_t *request = (request_t *)malloc(sizeof(request_t));
+	struct timespec deadline = {0};
+	size_t deadline_ns = NEVER;
+
+	if (NULL == request)
 	{
-		TaskDestroy(task);
 		return 1;
 	}
-	
+
+	request->submit.type = type;
+	request->uid = uid;
+	request->interval = interval;
+
+	/* a remove never needs the loop earlier, a stop always does,
+	   a reschedule may bring the task before the loop's deadline */
+	if (SUBMIT_STOP == type)
+	{
+		deadline_ns = 0;
+	}
+	else if (SUBMIT_RESCHEDULE == type)
+	{
+		SchTime(sch, &deadline);
+		TimeAddMs(&deadline, interval);
+		deadline_ns = TimeToNs(&deadline);
+	}
+
+	Submit(sch, &request->submit, deadline_ns);
+
 	return 0;
 }
 
-static void SleepCheck(time_t time_to_sleep)
+static void Wake(sch_t *sch)
 {
-    while (0 != time_to_sleep)
-    {
-        time_to_sleep = sleep(time_to_sleep);
-    }
+	int event_fd = __atomic_load_n(&sch->event_fd, __ATOMIC_SEQ_CST);
+	int wake_fd = __atomic_load_n(&sch->wake_fd, __ATOMIC_SEQ_CST);
+
+	__atomic_add_fetch(&sch->wake_seq, 1, __ATOMIC_SEQ_CST);
+
+	/* a host stepping with SchRunOnce polls this one */
+	if (-1 != wake_fd)
+	{
+		WakeSignal(wake_fd);
+	}
+
+	if (-1 != event_fd)
+	{
+		WakeSignal(event_fd);
+
+		return;
+	}
+
+	syscall(SYS_futex, &sch->wake_seq, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+static void WakeSignal(int fd)
+{
+	unsigned long wakeup = 1;
+
+	if (0 > write(fd, &wakeup, sizeof(wakeup)))
+	{
+		wakeup = 0;
+	}
+}
+
+/* the requests are drained by the step that follows */
+static void WakeClear(int fd)
+{
+	unsigned long wakeups = 0;
+
+	if (-1 != fd && 0 > read(fd, &wakeups, sizeof(wakeups)))
+	{
+		wakeups = 0;
+	}
 }
 
+/* applies the requests in the order each thread made them */
+static void Drain(sch_t *sch)
+{
+	mpsc_node_t *link = MPSCQueuePop(sch->submits);
+
+	while (NULL != link)
+	{
+		submit_t *submit = LINK_TO_SUBMIT(link);
+
+		switch (submit->type)
+		{
+			case SUBMIT_ADD:
+				AddTask(sch, SUBMIT_TO_TASK(submit));
+				break;
+
+			case SUBMIT_REMOVE:
+				RemoveTask(sch, ((request_t *)submit)->uid);
+				free(submit);
+				break;
+
+			case SUBMIT_RESCHEDULE:
+			case SUBMIT_INTERVAL:
+				RescheduleTask(sch, ((request_t *)submit)->uid,
+								((request_t *)submit)->interval,
+								SUBMIT_RESCHEDULE == submit->type);
+				free(submit);
+				break;
+
+			case SUBMIT_STOP:
+				StopAll(sch);
+				free(submit);
+				break;
+		}
+
+		link = MPSCQueuePop(sch->submits);
+	}
+}
 
-/*method to sort the P_Q*/
-static int IsBefore(const void *data, const void *to_compare)
+/* caller holds the lock, destroys the task on failure */
+static int AddTask(sch_t *sch, task_t *task)
 {
-	const task_t *task_data = data;
-	const task_t *task_to_compare = to_compare;	
+	if (0 != UIDTableInsert(sch->tasks, task->uid, task))
+	{
+		TaskDestroy(task);
+
+		return 1;
+	}
 	
-	return ((task_data->time_to_run < task_to_compare->time_to_run) ? 0 : 1);
+	if (0 != QueuePush(sch, task))
+	{
+		UIDTableRemove(sch->tasks, task->uid);
+		TaskDestroy(task);
+
+		return 1;
+	}
+
+	/* a new earliest deadline has to wake the timer thread */
+	if (0 < sch->nworkers && QueueIsNext(sch, task))
+	{
+		pthread_cond_signal(&sch->timer_cond);
+	}
+
+	return 0;
+}
+
+static void RemoveTask(sch_t *sch, ilrd_uid_t uid)
+{
+	task_t *task = NULL;
+
+	SchLock(sch);
+
+	task = UIDTableFind(sch->tasks, uid);
+
+	if (NULL == task)
+	{
+		SchUnlock(sch);
+
+		return;
+	}
+
+	UIDTableRemove(sch->tasks, uid);
+
+	/* O(1) either way, the run frees a running task when it returns */
+	if (TASK_RUNNING == task->state)
+	{
+		task->state = TASK_CANCELLED;
+	}
+	else
+	{
+		QueueRemove(sch, task);
+		TaskDestroy(task);
+	}
+
+	SchUnlock(sch);
 }
 
+static int RescheduleTask(sch_t *sch, ilrd_uid_t uid, size_t interval,
+																int restart)
+{
+	task_t *task = NULL;
+
+	SchLock(sch);
+
+	task = UIDTableFind(sch->tasks, uid);
+
+	if (NULL == task)
+	{
+		SchUnlock(sch);
+
+		return 1;
+	}
+
+	task->interval = interval;
+
+	/* the slack stays within half the new interval, as at creation */
+	task->slack = (task->slack < interval / 2) ? task->slack : interval / 2;
 
+	/* a queued task moves within its queue, no allocation. A running
+	   or suspended one starts over from the end of the run */
+	if (restart && TASK_QUEUED == task->state && NULL == task->co)
+	{
+		SchTime(sch, &task->period_start);
+		QueueRemove(sch, task);
+		TimeAddMs(&task->period_start, interval);
+		task->time_to_run = task->period_start;
+		task->is_late = 0;
+		TaskSlack(task);
+
+		if (0 != QueuePush(sch, task))
+		{
+			UIDTableRemove(sch->tasks, uid);
+			TaskDestroy(task);
+			SchUnlock(sch);
+
+			return 1;
+		}
+
+		if (0 < sch->nworkers && QueueIsNext(sch, task))
+		{
+			pthread_cond_signal(&sch->timer_cond);
+		}
+	}
+	else if (restart)
+	{
+		task->restart = 1;
+	}
+
+	SchUnlock(sch);
+
+	return 0;
+}
@@ -3,6 +3,12 @@
 
 #include <stddef.h>          /* size_t */
 #include "ilrd_uid.h"        /* ilrd_uid_t */
+#include "histogram.h"       /* hist_t */
+
+struct timespec;
+
+/* SchRunOnce with no task queued */
+#define SCH_NO_DEADLINE ((size_t)-1)
 
 typedef struct sch_s sch_t;
 /*
@@ -10,12 +16,185 @@ typedef struct sch_s sch_t;
 */
 typedef int (*opt_t)(void *arg);
 
+/*
+    called with the ready events of fd,
+    return signals to scheduler - 0 to keep watching fd, !0 to stop
+*/
+typedef int (*fd_opt_t)(int fd, unsigned int events, void *arg);
+
+/*
+    what a periodic task does when it falls a whole interval or more
+    behind its schedule (it ran long, or the scheduler was busy):
+        SCH_SKIP - drop the missed ticks, resume on the next one due
+        SCH_CATCH_UP - run once right away for all missed ticks,
+                        then resume on schedule
+        SCH_BURST - run every missed tick back to back
+*/
+typedef enum
+{
+    SCH_CATCH_UP,
+    SCH_SKIP,
+    SCH_BURST
+} sch_overrun_t;
+
+/*
+    priority lanes, each with its own queue. Of the tasks due at once,
+    the ones in a higher lane run first (see SchSetLanes)
+        SCH_LANE_CRITICAL - heartbeats and such, never wait for the others
+        SCH_LANE_NORMAL - the default
+        SCH_LANE_BACKGROUND - bulk work, runs when nothing else is due
+*/
+typedef enum
+{
+    SCH_LANE_CRITICAL,
+    SCH_LANE_NORMAL,
+    SCH_LANE_BACKGROUND,
+    SCH_LANES
+} sch_lane_t;
+
+/*
+    how due tasks of different lanes are ordered
+        SCH_LANES_STRICT - a lane runs only when the lanes above it have
+                        nothing due (the default)
+        SCH_LANES_WEIGHTED - each lane gets its weight in runs per round,
+                        so a busy lane cannot starve the lanes below it
+*/
+typedef enum
+{
+    SCH_LANES_STRICT,
+    SCH_LANES_WEIGHTED
+} sch_lane_policy_t;
+
+/*
+    per task attributes, initialize with SchAttrInit then set fields
+        interval - milliseconds between runs
+        overrun - what to do with missed ticks
+        max_runtime - milliseconds a run may take, 0 for no limit.
+                    A run that takes longer is counted as an overrun,
+                    see SchSetSpare
+        stack_size - 0 for a plain task. Otherwise the task runs as a
+                    coroutine on its own stack of that many bytes
+                    (rounded up to pages, at least 8 KiB), and may
+                    suspend with SchYield and SchSleepFor
+        lane - priority lane, SCH_LANE_NORMAL by default
+        key - 0 by default. Tasks with a key are saved by SchSave,
+                    SchLoad hands the key back to find their operation
+        slack - milliseconds a run may start late, 0 by default, at
+                    most half the interval, cut down again when the
+                    interval shrinks. Each run is moved to a
+                    round time within its window, so tasks whose
+                    windows overlap mostly run on one wakeup. The
+                    period stays anchored to the exact deadlines
+
+    WARNING!!! fields may be added, always start from SchAttrInit
+*/
+typedef struct sch_attr_s
+{
+    size_t interval;
+    sch_overrun_t overrun;
+    size_t max_runtime;
+    size_t stack_size;
+    sch_lane_t lane;
+    size_t key;
+    size_t slack;
+} sch_attr_t;
+
+/*
+    time source of a scheduler, see SchSetClock
+        now - current time, on any clock that only moves forward
+        sleep_until - wait until the deadline, on the same clock
+        arg - passed to both
+*/
+typedef struct sch_clock_s
+{
+    void (*now)(struct timespec *now, void *arg);
+    void (*sleep_until)(const struct timespec *deadline, void *arg);
+    void *arg;
+} sch_clock_t;
+
+/*
+    scheduler wide statistics, times in nanoseconds on CLOCK_MONOTONIC
+        runs - task runs
+        tasks - tasks in the scheduler at the snapshot
+        longest_uid, longest_ns - the single longest run
+        lateness - start of a run minus its deadline
+        runtime - time in the task function
+        queue_depth - tasks waiting, once per run loop pass
+*/
+typedef struct sch_stats_s
+{
+    size_t runs;
+    size_t tasks;
+    ilrd_uid_t longest_uid;
+    size_t longest_ns;
+    hist_t lateness;
+    hist_t runtime;
+    hist_t queue_depth;
+} sch_stats_t;
+
+/*
+    per task statistics, times in nanoseconds
+*/
+typedef struct sch_task_stats_s
+{
+    size_t runs;
+    size_t total_ns;
+    size_t max_ns;
+    size_t max_late_ns;
+    size_t missed;
+    size_t overruns;
+} sch_task_stats_t;
+
+/*
+    shared memory layout written by SchStatsExportShm.
+    seq is odd while a snapshot is being written: read seq, copy stats,
+    read seq again, the copy holds if both are the same and even.
+*/
+#define SCH_STATS_MAGIC (0x53434853UL)
+#define SCH_STATS_VERSION (1)
+
+typedef struct sch_stats_shm_s
+{
+    unsigned long magic;
+    unsigned long version;
+    size_t seq;
+    sch_stats_t stats;
+} sch_stats_shm_t;
+
 /*
     Create a new Scheduler, returns a reference to it.
                                       NULL on failure.
 */
 sch_t *SchCreate(void);
 
+/*
+    Create a new Scheduler on a hierarchical timing wheel.
+        Same API as SchCreate, but add, remove and every tick are O(1),
+        for very large numbers of tasks.
+        Deadlines are rounded to the wheel tick.
+
+    Returns a reference to it, NULL on failure.
+*/
+sch_t *SchCreateWheel(void);
+
+/*
+    Create a new Scheduler that runs tasks on nthreads worker threads.
+        Same API as SchCreate. SchRun becomes the timer thread: it hands
+        due tasks to per worker queues, idle workers steal from busy ones,
+        so a slow task does not hold back the others.
+        A task never runs on two threads at once, tasks may run in
+        parallel with each other and must synchronize shared data.
+        SchAdd, SchRemove and SchStop may be called from any thread.
+        SchStop drops dispatched tasks instead of running them.
+        SchAddFd is not supported.
+
+        Arguments:
+            nthreads - number of workers, at least 1
+
+    Returns a reference to it, NULL on failure.
+*/
+sch_t *SchCreateParallel(size_t nthreads);
+
 /*
     Destroy a given Scheduler.
         All tasks will me erased, all references will become invalid.
@@ -29,14 +208,19 @@ void SchDestroy(sch_t *sch);
 
 /*
     Returns number of tasks in a given scheduler.
+        Called by the owner after SchRun returned, it first applies the
+        requests other threads queued since, so their tasks count.
 
         Arguments:
             scheduler.
+
+    complexity O(1), plus the requests it applies
 */
-size_t SchSize(const sch_t *sch);
+size_t SchSize(sch_t *sch);
 
 /*
     Checks if a given scheduler is empty.
+        Applies queued requests first, as SchSize does.
 
         Arguments:
             scheduler.
@@ -44,14 +228,21 @@ size_t SchSize(const sch_t *sch);
     Returns true if empty,
             false otherwise
 */
-int SchIsEmpty(const sch_t *sch);
+int SchIsEmpty(sch_t *sch);
 
 /*
     Add a new task to a given scheduler.
+        Once SchRun was called, other threads may add too: the task is
+        queued lock free and the run loop takes it on its next pass,
+        waking up for it if it is due before the loop's next deadline.
 
         Arguments:
             scheduler. - the scheduler
-                        interval - milliseconds between calls to opt
+                        interval - milliseconds between calls to opt,
+                                measured on CLOCK_MONOTONIC.
+                                Deadlines are anchored, a task that
+                                falls behind catches up once
+                                (see SchAddAttr)
             operation - task function. Must conform with opt_t as described
                 above
             arg - any other things needed for user to perform operation        
@@ -60,19 +251,356 @@ int SchIsEmpty(const sch_t *sch);
 */
 ilrd_uid_t SchAdd(sch_t *sch, size_t interval, opt_t operation, void *arg);
 
+/*
+    Set attributes to the defaults SchAdd uses.
+
+        Arguments:
+            attr - attributes to initialize
+            interval - milliseconds between calls to the task
+*/
+void SchAttrInit(sch_attr_t *attr, size_t interval);
+
+/*
+    Add a new task with the given attributes, see SchAdd.
+        Deadlines are anchored: each one is the previous deadline plus
+        interval, not the time the task returned, so the period does
+        not drift with run time or wake up latency.
+        attr->overrun decides what happens to ticks that were missed.
+
+        Arguments:
+            sch - the scheduler
+            attr - task attributes, copied
+            operation - task function
+            arg - any other things needed for user to perform operation
+
+    Returns unique id of new task, bad uid otherwise
+*/
+ilrd_uid_t SchAddAttr(sch_t *sch, const sch_attr_t *attr, opt_t operation,
+                                                                void *arg);
+
+/*
+    Number of ticks a task has missed so far: ticks dropped by SCH_SKIP,
+    ticks folded into a single run by SCH_CATCH_UP. SCH_BURST runs every
+    tick late and never misses one.
+    Call from the thread that runs the scheduler, or from a task.
+
+    Arguments:
+        sch - scheduler
+        uid - id of the task
+
+    Returns the count, 0 if there is no such task
+*/
+size_t SchMissedTicks(const sch_t *sch, ilrd_uid_t uid);
+
+/*
+    Suspend the running coroutine task, see sch_attr_t stack_size.
+        It goes back in the queue due now and resumes right after the
+        tasks already due, on the same stack, where it left off.
+        Its deadline and period are left alone: each time the task
+        function returns, the next run starts from the top a period
+        after the previous one.
+        A coroutine removed or stopped while suspended is dropped
+        where it stopped, nothing on its stack is unwound.
+        Stacks are pooled, only coroutines part way through hold one.
+
+    Arguments:
+        sch - scheduler running the task
+
+    Returns 0 once resumed, !0 if not called from a coroutine task
+*/
+int SchYield(sch_t *sch);
+
+/*
+    Suspend the running coroutine task for ms milliseconds, see SchYield.
+
+    Arguments:
+        sch - scheduler running the task
+        ms - milliseconds until it resumes
+
+    Returns 0 once resumed, !0 if not called from a coroutine task
+*/
+int SchSleepFor(sch_t *sch, size_t ms);
+
+/*
+    Keep tasks running on time while one task is stuck.
+        The first run of a task with a max runtime starts a monitor
+        thread, which counts runs that go past it. With a spare, the
+        monitor then runs the other tasks itself until the stuck task
+        returns, and hands the loop back.
+        With a spare, SchAdd, SchRemove and SchStop calls made by a task
+        with a max runtime are queued like calls from other threads.
+        Tasks run by the spare are not watched.
+        Not supported by SchCreateParallel, its workers keep going anyway
+        (overruns are still counted there, once the task returns).
+
+    Arguments:
+        sch - scheduler
+        enable - !0 to let the monitor run the other tasks, 0 to only count
+
+    Returns 0 on success, !0 on failure
+*/
+int SchSetSpare(sch_t *sch, int enable);
+
+/*
+    Choose how tasks of different lanes that are due together are ordered.
+        Within a lane tasks run by deadline. Lanes only reorder tasks that
+        are already due, no task runs early.
+    Call from the thread that runs the scheduler, from a task, or
+    before SchRun.
+
+    Arguments:
+        sch - scheduler
+        policy - strict or weighted
+        weight - runs per round for each lane, all above 0,
+                ignored (may be NULL) for SCH_LANES_STRICT
+
+    Returns 0 on success, !0 on failure
+*/
+int SchSetLanes(sch_t *sch, sch_lane_policy_t policy,
+                                        const size_t weight[SCH_LANES]);
+
+/*
+    snapshot file written by SchSave: a header of four size_t
+    (magic, version, record size, count), then one fixed size record
+    per task. A file of another version or record size is refused.
+*/
+#define SCH_SNAP_MAGIC (0x50414E53UL)
+#define SCH_SNAP_VERSION (2)
+
+/*
+    finds the operation of a task restored by SchLoad.
+        key - the task's key
+        operation, arg - set them for the task
+        param - as given to SchLoad
+
+    return 0 to restore the task, !0 to leave it out
+*/
+typedef int (*sch_bind_t)(size_t key, opt_t *operation, void **arg,
+                                                            void *param);
+
+/*
+    Save every task that has a key to a file, for SchLoad.
+        Deadlines are saved as they are, so a process started after an
+        exec picks up each task in its original phase (CLOCK_MONOTONIC
+        is shared by all processes on the machine). Refused on a
+        scheduler with a custom clock (SchSetClock, SchVirtualClock).
+        A task saved while suspended or running starts over.
+        The file is written next to path and renamed over it, readers
+        never see half a snapshot.
+    Call from the thread that runs the scheduler, from a task, or
+    before SchRun.
+
+    Arguments:
+        sch - scheduler
+        path - file to write
+
+    Returns 0 on success, !0 on failure
+*/
+int SchSave(const sch_t *sch, const char *path);
+
+/*
+    Add the tasks saved by SchSave, with their deadlines and missed
+    ticks. The file is mapped once and read in place.
+        Tasks get new uids. A deadline that passed while no process
+        ran its task is handled by the task's overrun policy.
+        Refused on a scheduler with a custom clock, as SchSave is.
+    Call from the thread that runs the scheduler, from a task, or
+    before SchRun.
+
+    Arguments:
+        sch - scheduler
+        path - file written by SchSave
+        bind - called once per saved task
+        param - passed to bind
+
+    Returns 0 on success, !0 on failure (tasks restored until then stay)
+*/
+int SchLoad(sch_t *sch, const char *path, sch_bind_t bind, void *param);
+
+/*
+    Replace the scheduler's clock, by default CLOCK_MONOTONIC.
+        Task deadlines, lateness and run times in the statistics are all
+        on this clock. When nothing is due the run loop calls sleep_until
+        instead of sleeping, requests from other threads are taken once
+        it returns. Max runtimes are still watched on the real clock.
+        Not supported with SchCreateParallel or watched fds, and
+        SchSave and SchLoad refuse a scheduler on a custom clock.
+    Call while the scheduler is empty, before SchRun.
+
+    Arguments:
+        sch - scheduler
+        clock - new clock, NULL for the real one again
+
+    Returns 0 on success, !0 on failure
+*/
+int SchSetClock(sch_t *sch, const sch_clock_t *clock);
+
+/*
+    Fill a simulated clock: time stands still while tasks run and jumps
+    straight to the next deadline, so hours of schedule replay in
+    milliseconds, the same way every time.
+
+    Arguments:
+        clock - clock to fill, for SchSetClock
+        now - the simulated time, set it to the start time.
+                Must outlive the scheduler's use of the clock,
+                tasks may read it or move it forward
+*/
+void SchVirtualClock(sch_clock_t *clock, struct timespec *now);
+
+/*
+    Current time on the scheduler's clock, see SchSetClock.
+
+    Arguments:
+        sch - scheduler
+        now - receives the time
+*/
+void SchNow(const sch_t *sch, struct timespec *now);
+
+/*
+    Number of runs that went past their task's max runtime.
+    May be called from any thread.
+
+    Arguments:
+        sch - scheduler
+*/
+size_t SchOverruns(const sch_t *sch);
+
+/*
+    Turn statistics on or off, they are off after SchCreate.
+        Turning them on starts from zero. While on, each run costs one
+        clock read and a few counter updates.
+    Call from the thread that runs the scheduler, from a task, or
+    before SchRun.
+
+    Arguments:
+        sch - scheduler
+        enable - !0 to turn on, 0 to turn off
+
+    Returns 0 on success, !0 on failure
+*/
+int SchSetStats(sch_t *sch, int enable);
+
+/*
+    Copy the statistics gathered so far.
+    Call from the thread that runs the scheduler, from a task, or
+    before SchRun.
+
+    Arguments:
+        sch - scheduler
+        stats - snapshot to fill
+
+    Returns 0 on success, !0 if statistics are off
+*/
+int SchGetStats(const sch_t *sch, sch_stats_t *stats);
+
+/*
+    Copy the statistics of one task, gathered while statistics were on.
+    Call from the thread that runs the scheduler, or from a task.
+
+    Arguments:
+        sch - scheduler
+        uid - id of the task
+        stats - snapshot to fill
+
+    Returns 0 on success, !0 if there is no such task
+*/
+int SchGetTaskStats(const sch_t *sch, ilrd_uid_t uid,
+                                                sch_task_stats_t *stats);
+
+/*
+    Write a snapshot as text, one "name value" line per field,
+    percentiles for each histogram.
+        The file is written aside and renamed into place, so readers
+        never see half a snapshot. A path under /dev/shm stays in memory.
+    Handy from a periodic task:
+        SchGetStats(sch, &stats); SchStatsExport(&stats, path);
+
+    Arguments:
+        stats - snapshot from SchGetStats
+        path - file to write
+
+    Returns 0 on success, !0 on failure
+*/
+int SchStatsExport(const sch_stats_t *stats, const char *path);
+
+/*
+    Publish a snapshot in POSIX shared memory as a sch_stats_shm_t,
+    created on first use, for a monitor process to map and read.
+
+    Arguments:
+        stats - snapshot from SchGetStats
+        name - shared memory object name, "/name"
+
+    Returns 0 on success, !0 on failure
+*/
+int SchStatsExportShm(const sch_stats_t *stats, const char *name);
+
 /*
     Removes a specific task from scheduler
+    Once SchRun was called, a remove from another thread is applied
+    on the run loop's next pass.
+    A running task may be removed too, by itself, another task or
+    another thread: it finishes the run and is not queued again.
 
     Arguments:
         sch - sheduler to remove from
         uid  - id to identify task by
+
+    Returns 0 on success, !0 if a remove from another thread could
+    not be handed over (out of memory), the task then stays
+
+    complexity O(log n), O(1) for SchCreateWheel
+*/
+int SchRemove(sch_t *sch, ilrd_uid_t uid);
+
+/*
+    Start a new period for a task: its next run is interval
+    milliseconds from now, then every interval after that.
+        The task moves within the queue, nothing is allocated.
+        A running task (or a suspended coroutine) starts the new period
+        when its run returns. From another thread it is applied on the
+        run loop's next pass, 0 then only means it was handed over.
+
+    Arguments:
+        sch - scheduler
+        uid - id of the task
+        interval - new interval in milliseconds
+
+    Returns 0 on success, !0 if there is no such task
+
+    complexity O(log n), O(1) for SchCreateWheel
 */
-void SchRemove(sch_t *sch, ilrd_uid_t uid);
+int SchReschedule(sch_t *sch, ilrd_uid_t uid, size_t interval);
+
+/*
+    Change the interval of a task and keep its phase: the run already
+    due stays where it is, the runs after it are interval apart.
+        From another thread it is applied on the run loop's next pass,
+        0 then only means it was handed over.
+
+    Arguments:
+        sch - scheduler
+        uid - id of the task
+        interval - new interval in milliseconds
+
+    Returns 0 on success, !0 if there is no such task
+
+    complexity O(1)
+*/
+int SchSetInterval(sch_t *sch, ilrd_uid_t uid, size_t interval);
 
 /*
     Start scheduler
 
     Blcoks thread indifferently, or until a task op causes it to stop
+    The calling thread becomes the owner of the scheduler: from then on
+    SchAdd, SchRemove and SchStop from other threads are handed to it,
+    also after SchRun returns, until the next SchRun or SchDestroy.
+    Requests queued before it returns are applied before it returns,
+    later ones by the owner's next SchSize, SchIsEmpty, SchRun or
+    SchDestroy. A task added after the return runs only if SchRun is
+    called again.
 
     Arguments:
         sch - scheduler
@@ -81,15 +609,95 @@ void SchRemove(sch_t *sch, ilrd_uid_t uid);
 */
 ilrd_uid_t SchRun(sch_t *sch);
 
+/*
+    Run one step of the loop, for an application that drives the
+    scheduler from its own event loop instead of a thread in SchRun.
+        Runs the tasks that are due now, polls watched fds without
+        blocking and applies requests from other threads, then returns.
+        The calling thread becomes the owner, as with SchRun. Requests
+        from other threads wait for the next call: a host that sleeps
+        on the returned timeout alone hears of them only when it ends.
+        Poll SchWakeFd as well to be woken for them.
+        A monitor started for max runtimes stays up until SchDestroy.
+
+    Arguments:
+        sch - scheduler, not from SchCreateParallel
+
+    Returns milliseconds until the next deadline, rounded up (0 if a
+    task is due already), SCH_NO_DEADLINE if no task is queued
+*/
+size_t SchRunOnce(sch_t *sch);
+
+/*
+    Get a file descriptor that becomes readable when another thread's
+    SchAdd, SchRemove, SchReschedule or SchStop needs the next
+    SchRunOnce sooner than the timeout it returned.
+        Created on the first call, closed by SchDestroy. SchRunOnce
+        clears it, the host only polls it for POLLIN/EPOLLIN.
+
+    Arguments:
+        sch - scheduler, not from SchCreateParallel
+
+    Returns the descriptor, -1 on failure or for a parallel scheduler
+*/
+int SchWakeFd(sch_t *sch);
+
+/*
+    Like SchRun, but returns once deadline has passed.
+        Also returns when the queue empties or a task calls SchStop.
+
+    Arguments:
+        sch - scheduler, not from SchCreateParallel
+        deadline - absolute time on the scheduler's clock (see SchNow)
+
+    Returns uid of the last task performed, a bad uid if none ran
+*/
+ilrd_uid_t SchRunUntil(sch_t *sch, const struct timespec *deadline);
+
+/*
+    Watch a file descriptor from the scheduler's own loop.
+        The first call switches the scheduler to reactor mode:
+        SchRun then waits in epoll_wait, with a timerfd armed to the
+        earliest task deadline, and dispatches fd events and tasks
+        from the same thread.
+        SchRun keeps running while tasks or watched fds remain.
+
+    Arguments:
+        sch - scheduler
+        fd - file descriptor, best non blocking. One watch per fd.
+        events - epoll events to wait for (EPOLLIN, EPOLLOUT, ...)
+        operation - called with the ready events
+        arg - any other things needed for user to perform operation
+
+    Call from the thread that runs the scheduler.
+
+    Returns 0 on success, !0 on failure
+*/
+int SchAddFd(sch_t *sch, int fd, unsigned int events, fd_opt_t operation,
+                                                                void *arg);
+
+/*
+    Stop watching a file descriptor, fd is not closed.
+    Remove fds before closing them.
+
+    Arguments:
+        sch - scheduler
+        fd - file descriptor
+*/
+void SchRemoveFd(sch_t *sch, int fd);
+
 /*
     Stop run of given scheduler
-    Removes all tasks, handle remains valid
+    Removes all tasks and fd watches, handle remains valid
+    Once SchRun was called, a stop from another thread wakes the run loop.
 
     Arguments:
         sch - scheduler
 
+    Returns 0 on success, !0 if a stop from another thread could not
+    be handed over (out of memory), the run then goes on
 */
-void SchStop(sch_t *sch);
+int SchStop(sch_t *sch);
 
 
 #endif /* SH_SCHEDULER_H */
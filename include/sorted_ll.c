@@ -6,16 +6,72 @@
 #include "dllist.h"
 #include "sorted_ll.h"
 
+#define MAX_LEVEL (16)
+#define SEED (12345)
+#define NEXT(node, level) ((node)->link[2 * (level)])
+#define PREV(node, level) ((node)->link[2 * (level) + 1])
+#define ITER_TO_SNODE(x) ((snode_t *)(x).info)
+#define ITER_TO_LIST(x) ((sortedlist_t *)(x).list)
+#define ITER_TO_LINK(x) ((dlink_t *)(x).info)
+#define LINK_TO_DATA(list, x) ((void *)((char *)(x) - (list)->offset))
+#define DATA_TO_LINK(list, x) ((dlink_t *)((char *)(x) + (list)->offset))
+#define IS_DLIST(list) (LIST_NODES == (list)->kind || \
+												LIST_BLOCKS == (list)->kind)
+
+typedef enum
+{
+	LIST_NODES,
+	LIST_BLOCKS,
+	LIST_SKIP,
+	LIST_LINKS
+} list_kind_t;
 
-static sliter_t DiterToSliter(diter_t diter);
-static diter_t SliterToDiter(sliter_t sliter);
+typedef struct snode snode_t;
+
+/* link holds a next and a prev pointer for each of the node's levels */
+struct snode
+{
+	void *data;
+	size_t key;
+	size_t level;
+	snode_t *link[2];
+};
 
 struct sortedlist_s
 {
+	list_kind_t kind;
 	dlist_t *list;
 	is_before_t is_before;
+	dlink_t links;
+	size_t offset;
+	snode_t *head;
+	snode_t *tail;
+	size_t level;
+	size_t size;
+	size_t high_water;
+	size_t allocs;
+	unsigned long seed;
 };
 
+static sliter_t DiterToSliter(const sortedlist_t *list, diter_t diter);
+static diter_t SliterToDiter(sliter_t sliter);
+static sliter_t MakeSliter(const sortedlist_t *list, void *info);
+static void SizeInc(sortedlist_t *list);
+
+/****
+					Skip List Functions
+****/
+static snode_t *SkipNodeAlloc(size_t level);
+
+static size_t SkipRandomLevel(sortedlist_t *list);
+
+static void SkipLink(sortedlist_t *list, snode_t *node);
+
+static void SkipUnlink(sortedlist_t *list, snode_t *node);
+
+static int SkipIsBefore(const sortedlist_t *list, const snode_t *node1,
+														const snode_t *node2);
+
 sortedlist_t *SortedListCreate(is_before_t before_func)
 {
 	sortedlist_t *sort_list = (sortedlist_t *)malloc(sizeof(sortedlist_t));
@@ -34,7 +90,135 @@ sortedlist_t *SortedListCreate(is_before_t before_func)
 		return NULL;
 	}
 
+	sort_list->kind = LIST_NODES;
+	sort_list->is_before = before_func;
+	sort_list->head = NULL;
+	sort_list->tail = NULL;
+
+	return sort_list;
+}
+
+sortedlist_t *SortedListCreateUnrolled(is_before_t before_func)
+{
+	sortedlist_t *sort_list = (sortedlist_t *)malloc(sizeof(sortedlist_t));
+
+	if (NULL == sort_list)
+	{
+		return NULL;
+	}
+
+	sort_list->list = DLCreateUnrolled();
+
+	if (NULL == sort_list->list)
+	{
+		free(sort_list);
+
+		return NULL;
+	}
+
+	sort_list->kind = LIST_BLOCKS;
 	sort_list->is_before = before_func;
+	sort_list->head = NULL;
+	sort_list->tail = NULL;
+
+	return sort_list;
+}
+
+sortedlist_t *SortedListCreateSkip(is_before_t before_func)
+{
+	sortedlist_t *sort_list = (sortedlist_t *)malloc(sizeof(sortedlist_t));
+	size_t i = 0;
+
+	if (NULL == sort_list)
+	{
+		return NULL;
+	}
+
+	sort_list->head = SkipNodeAlloc(MAX_LEVEL);
+	sort_list->tail = SkipNodeAlloc(MAX_LEVEL);
+
+	if (NULL == sort_list->head || NULL == sort_list->tail)
+	{
+		free(sort_list->head);
+		free(sort_list->tail);
+		free(sort_list);
+
+		return NULL;
+	}
+
+	for (i = 0; i < MAX_LEVEL; ++i)
+	{
+		NEXT(sort_list->head, i) = sort_list->tail;
+		PREV(sort_list->head, i) = NULL;
+		NEXT(sort_list->tail, i) = NULL;
+		PREV(sort_list->tail, i) = sort_list->head;
+	}
+
+	sort_list->kind = LIST_SKIP;
+	sort_list->list = NULL;
+	sort_list->is_before = before_func;
+	sort_list->level = 1;
+	sort_list->size = 0;
+	sort_list->high_water = 0;
+	sort_list->allocs = 0;
+	sort_list->seed = SEED;
+
+	return sort_list;
+}
+
+/* a skip list without a before_func, its nodes compare by key */
+sortedlist_t *SortedListCreateKeyed(void)
+{
+	return SortedListCreateSkip(NULL);
+}
+
+sortedlist_t *SortedListCreateIntrusive(is_before_t before_func,
+														size_t link_offset)
+{
+	sortedlist_t *sort_list = (sortedlist_t *)malloc(sizeof(sortedlist_t));
+
+	if (NULL == sort_list)
+	{
+		return NULL;
+	}
+
+	DLLinkInit(&sort_list->links);
+	sort_list->kind = LIST_LINKS;
+	sort_list->list = NULL;
+	sort_list->is_before = before_func;
+	sort_list->offset = link_offset;
+	sort_list->head = NULL;
+	sort_list->tail = NULL;
+	sort_list->size = 0;
+	sort_list->high_water = 0;
+	sort_list->allocs = 0;
+
+	return sort_list;
+}
+
+sortedlist_t *SortedListCreateFromArena(is_before_t before_func,
+														arena_t *arena)
+{
+	sortedlist_t *sort_list = (sortedlist_t *)malloc(sizeof(sortedlist_t));
+		
+	if (NULL == sort_list)
+	{
+		return NULL;
+	}
+	
+	sort_list->list = DLCreateFromArena(arena);
+
+	if (NULL == sort_list->list)
+	{
+		free(sort_list);		
+	
+		return NULL;
+	}
+
+	sort_list->kind = LIST_NODES;
+	sort_list->is_before = before_func;
+	sort_list->head = NULL;
+	sort_list->tail = NULL;
 
 	return sort_list;
 }
@@ -42,6 +226,31 @@ sortedlist_t *SortedListCreate(is_before_t before_func)
 void SortedListDestroy(sortedlist_t *list)
 {
 	assert(list);
+
+	/* linked elements belong to the user */
+	if (LIST_LINKS == list->kind)
+	{
+		free(list);
+
+		return;
+	}
+
+	if (LIST_SKIP == list->kind)
+	{
+		snode_t *node = list->head;
+
+		while (NULL != node)
+		{
+			snode_t *next = NEXT(node, 0);
+
+			free(node);
+			node = next;
+		}
+
+		free(list);
+
+		return;
+	}
 	
 	DLDestroy(list->list);
 	
@@ -50,17 +259,69 @@ void SortedListDestroy(sortedlist_t *list)
 
 size_t SortedListCount(const sortedlist_t *list)
 {
+	if (!IS_DLIST(list))
+	{
+		return list->size;
+	}
+
 	return DLCount(list->list);
 }
 
+void SortedListStats(const sortedlist_t *list, sl_stats_t *stats)
+{
+	dl_stats_t dl_stats = {0};
+
+	assert(list);
+	assert(stats);
+
+	if (!IS_DLIST(list))
+	{
+		stats->size = list->size;
+		stats->high_water = list->high_water;
+		stats->allocs = list->allocs;
+
+		return;
+	}
+
+	DLStats(list->list, &dl_stats);
+	stats->size = dl_stats.size;
+	stats->high_water = dl_stats.high_water;
+	stats->allocs = dl_stats.allocs;
+}
+
 int SortedListIsEmpty(const sortedlist_t *list)
 {
+	if (!IS_DLIST(list))
+	{
+		return (0 == list->size);
+	}
+
 	return DLIsEmpty(list->list);
 }
 
 sliter_t SortedListInsert(sortedlist_t *list, void *data)
 {
-	sliter_t iter = SortedListBegin(list);
+	sliter_t iter = {0};
+
+	assert(list->is_before);
+
+	if (LIST_SKIP == list->kind)
+	{
+		snode_t *node = SkipNodeAlloc(SkipRandomLevel(list));
+
+		if (NULL == node)
+		{
+			return SortedListEnd(list);
+		}
+
+		node->data = data;
+		SkipLink(list, node);
+		++list->allocs;
+
+		return MakeSliter(list, node);
+	}
+
+	iter = SortedListBegin(list);
 
 	while (!((SortedListIsSameIter(iter,SortedListEnd(list)))) 
 		  					&& !(list->is_before(data,SortedListGetData(iter))))
@@ -68,14 +329,126 @@ sliter_t SortedListInsert(sortedlist_t *list, void *data)
 			iter = SortedListNext(iter);
 		}
 
-	iter = DiterToSliter(DLInsert(list->list, SliterToDiter(iter), data));
+	if (LIST_LINKS == list->kind)
+	{
+		DLLinkInsert(ITER_TO_LINK(iter), DATA_TO_LINK(list, data));
+		SizeInc(list);
+		iter.info = DATA_TO_LINK(list, data);
+
+		return iter;
+	}
+
+	iter = DiterToSliter(list,
+						DLInsert(list->list, SliterToDiter(iter), data));
 
 	return iter;
 }
 
+sliter_t SortedListInsertKeyed(sortedlist_t *list, void *data, size_t key)
+{
+	snode_t *node = NULL;
+
+	assert(list);
+	assert(LIST_SKIP == list->kind && NULL == list->is_before);
+
+	node = SkipNodeAlloc(SkipRandomLevel(list));
+
+	if (NULL == node)
+	{
+		return SortedListEnd(list);
+	}
+
+	node->data = data;
+	node->key = key;
+	SkipLink(list, node);
+	++list->allocs;
+
+	return MakeSliter(list, node);
+}
+
+sliter_t SortedListSearch(sortedlist_t *list, const void *to_find)
+{
+	sliter_t iter = {0};
+	snode_t *node = NULL;
+	size_t level = 0;
+
+	assert(list);
+	assert(list->is_before);
+
+	if (LIST_SKIP != list->kind)
+	{
+		iter = SortedListBegin(list);
+
+		while (!SortedListIsSameIter(iter, SortedListEnd(list))
+					&& list->is_before(SortedListGetData(iter), to_find))
+		{
+			iter = SortedListNext(iter);
+		}
+	}
+	else
+	{
+		node = list->head;
+
+		for (level = list->level; 0 < level; --level)
+		{
+			while (NEXT(node, level - 1) != list->tail && list->is_before(
+								NEXT(node, level - 1)->data, to_find))
+			{
+				node = NEXT(node, level - 1);
+			}
+		}
+
+		iter = MakeSliter(list, NEXT(node, 0));
+	}
+
+	if (SortedListIsSameIter(iter, SortedListEnd(list))
+				|| list->is_before(to_find, SortedListGetData(iter)))
+	{
+		return SortedListEnd(list);
+	}
+
+	return iter;
+}
+
+sliter_t SortedListSearchKey(sortedlist_t *list, size_t key)
+{
+	snode_t *node = NULL;
+	size_t level = 0;
+
+	assert(list);
+	assert(LIST_SKIP == list->kind && NULL == list->is_before);
+
+	node = list->head;
+
+	for (level = list->level; 0 < level; --level)
+	{
+		while (NEXT(node, level - 1) != list->tail
+									&& NEXT(node, level - 1)->key < key)
+		{
+			node = NEXT(node, level - 1);
+		}
+	}
+
+	node = NEXT(node, 0);
+
+	if (node == list->tail || node->key != key)
+	{
+		return SortedListEnd(list);
+	}
+
+	return MakeSliter(list, node);
+}
+
 void *SortedListPopBack(sortedlist_t *list)
 {
 	void *data = SortedListGetData(SortedListPrev(SortedListEnd(list)));
+
+	if (!IS_DLIST(list))
+	{
+		SortedListErase(SortedListPrev(SortedListEnd(list)));
+
+		return data;
+	}
 	
 	DLPopBack(list->list);
 	
@@ -85,6 +458,13 @@ void *SortedListPopBack(sortedlist_t *list)
 void *SortedListPopFront(sortedlist_t *list)
 {
 	void *data = SortedListGetData(SortedListBegin(list));
+
+	if (!IS_DLIST(list))
+	{
+		SortedListErase(SortedListBegin(list));
+
+		return data;
+	}
 	
 	DLPopFront(list->list);
 	
@@ -100,7 +480,21 @@ int SortedListForEach
                 void *arg
               )
 {
-	return DLForEach(SliterToDiter(from), SliterToDiter(to), opt_func, arg);
+	int res = 0;
+
+	if (IS_DLIST(ITER_TO_LIST(from)))
+	{
+		return DLForEach(SliterToDiter(from), SliterToDiter(to),
+															opt_func, arg);
+	}
+
+	while (!SortedListIsSameIter(from, to) && 0 == res)
+	{
+		res = opt_func(SortedListGetData(from), arg);
+		from = SortedListNext(from);
+	}
+
+	return res;
 }
 
 sliter_t SortedListFind
@@ -133,22 +527,129 @@ sliter_t SortedListErase(sliter_t iter)
 	sliter_t new_iter = SortedListNext(iter);
 	sliter_t tmp_iter = {0};
 
+	if (LIST_LINKS == ITER_TO_LIST(iter)->kind)
+	{
+		DLLinkErase(ITER_TO_LINK(iter));
+		--ITER_TO_LIST(iter)->size;
+
+		return new_iter;
+	}
+
+	if (LIST_SKIP == ITER_TO_LIST(iter)->kind)
+	{
+		SkipUnlink(ITER_TO_LIST(iter), ITER_TO_SNODE(iter));
+		free(ITER_TO_SNODE(iter));
+
+		return new_iter;
+	}
+
 	tmp_iter.info = iter.info;
+	tmp_iter.list = iter.list;
 	
 	DLErase(SliterToDiter(tmp_iter)); 
 
 	return new_iter; 
 }
 
-void SortedListMerge(sortedlist_t *dest, sortedlist_t *src)
+int SortedListMerge(sortedlist_t *dest, sortedlist_t *src)
 {
 	sliter_t dest_iter = {0};
 	sliter_t from_iter = {0};
 	sliter_t to_iter = {0};
 	
 	assert(dest);
-	assert(dest->is_before);
 	assert(src);	
+	assert((NULL == dest->is_before) == (NULL == src->is_before));
+
+	if (LIST_SKIP == dest->kind && LIST_SKIP == src->kind)
+	{
+		/* the nodes move over, but iterators to them still name src */
+		while (0 != src->size)
+		{
+			snode_t *node = NEXT(src->head, 0);
+
+			SkipUnlink(src, node);
+			SkipLink(dest, node);
+		}
+
+		return 0;
+	}
+
+	assert(dest->is_before);
+
+	if (LIST_LINKS == dest->kind && LIST_LINKS == src->kind)
+	{
+		dlink_t *where = dest->links.next;
+
+		/* one pass, src is sorted so where only moves forward */
+		while (!DLLinkIsEmpty(&src->links))
+		{
+			dlink_t *link = src->links.next;
+
+			while (where != &dest->links && !dest->is_before(
+					LINK_TO_DATA(src, link), LINK_TO_DATA(dest, where)))
+			{
+				where = where->next;
+			}
+
+			DLLinkErase(link);
+			DLLinkInsert(where, link);
+			--src->size;
+			SizeInc(dest);
+		}
+
+		return 0;
+	}
+
+	/* a splice may move dest's elements, so they go in one by one */
+	if (LIST_BLOCKS == dest->kind && LIST_BLOCKS == src->kind)
+	{
+		dest_iter = SortedListBegin(dest);
+
+		while (!SortedListIsEmpty(src))
+		{
+			void *data = SortedListGetData(SortedListBegin(src));
+
+			while (!SortedListIsSameIter(dest_iter, SortedListEnd(dest))
+					&& !dest->is_before(data, SortedListGetData(dest_iter)))
+			{
+				dest_iter = SortedListNext(dest_iter);
+			}
+
+			dest_iter = DiterToSliter(dest, DLInsert(dest->list,
+											SliterToDiter(dest_iter), data));
+
+			if (SortedListIsSameIter(dest_iter, SortedListEnd(dest)))
+			{
+				return 1;
+			}
+
+			dest_iter = SortedListNext(dest_iter);
+			SortedListPopFront(src);
+		}
+
+		return 0;
+	}
+
+	/* nodes of another pool cannot move over, they are copied */
+	if (dest->kind != src->kind || !DLCanSplice(dest->list, src->list))
+	{
+		while (!SortedListIsEmpty(src))
+		{
+			sliter_t iter = SortedListInsert(dest,
+									SortedListGetData(SortedListBegin(src)));
+
+			/* src keeps the element dest could not take */
+			if (SortedListIsSameIter(iter, SortedListEnd(dest)))
+			{
+				return 1;
+			}
+
+			SortedListPopFront(src);
+		}
+
+		return 0;
+	}
 
 	dest_iter = SortedListBegin(dest);
 	from_iter = SortedListBegin(src);
@@ -167,7 +668,12 @@ void SortedListMerge(sortedlist_t *dest, sortedlist_t *src)
 						to_iter = SortedListNext(to_iter);
 					}
 	
-		DLSplice(SliterToDiter(from_iter),SliterToDiter(to_iter),SliterToDiter(dest_iter));
+		if (0 != DLSplice(SliterToDiter(from_iter),SliterToDiter(to_iter),
+											SliterToDiter(dest_iter)))
+		{
+			return 1;
+		}
+
 		from_iter = to_iter;
 		to_iter = SortedListNext(to_iter);
 	
@@ -179,16 +685,24 @@ void SortedListMerge(sortedlist_t *dest, sortedlist_t *src)
 	if (SortedListIsSameIter(dest_iter,SortedListEnd(dest)))
 	{
 		sliter_t to_iter = SortedListEnd(src);
-		DLSplice(SliterToDiter(from_iter),SliterToDiter(to_iter),
+		return DLSplice(SliterToDiter(from_iter),SliterToDiter(to_iter),
 											SliterToDiter(dest_iter));
 	}
 
 	else
 	{
 		void *data = SortedListGetData(SortedListBegin(src));
-		SortedListInsert(dest, data);
+
+		if (SortedListIsSameIter(SortedListInsert(dest, data),
+													SortedListEnd(dest)))
+		{
+			return 1;
+		}
+
 		SortedListErase(SortedListBegin(src));
 	}
+
+	return 0;
 }
 
 /******************************iter functions**********************************/
@@ -197,24 +711,76 @@ sliter_t SortedListBegin(sortedlist_t *list)
 {
 	assert(list);
 
-	return DiterToSliter(DLBegin(list->list));
+	if (LIST_LINKS == list->kind)
+	{
+		return MakeSliter(list, list->links.next);
+	}
+
+	if (LIST_SKIP == list->kind)
+	{
+		return MakeSliter(list, NEXT(list->head, 0));
+	}
+
+	return DiterToSliter(list, DLBegin(list->list));
 }
 
 sliter_t SortedListEnd(sortedlist_t *list)
 {
 	assert(list);
+
+	if (LIST_LINKS == list->kind)
+	{
+		return MakeSliter(list, &list->links);
+	}
+
+	if (LIST_SKIP == list->kind)
+	{
+		return MakeSliter(list, list->tail);
+	}
 	
-	return DiterToSliter(DLEnd(list->list));
+	return DiterToSliter(list, DLEnd(list->list));
 }
 
 sliter_t SortedListNext(sliter_t iter)
 {
-	return DiterToSliter(DLNext(SliterToDiter(iter)));
+	if (LIST_LINKS == ITER_TO_LIST(iter)->kind)
+	{
+		iter.info = ITER_TO_LINK(iter)->next;
+
+		return iter;
+	}
+
+	if (LIST_SKIP == ITER_TO_LIST(iter)->kind)
+	{
+		iter.info = NEXT(ITER_TO_SNODE(iter), 0);
+
+		return iter;
+	}
+
+	iter.info = DLNext(SliterToDiter(iter)).info;
+
+	return iter;
 }
 
 sliter_t SortedListPrev(sliter_t iter)
 {
-	return DiterToSliter(DLPrev(SliterToDiter(iter)));
+	if (LIST_LINKS == ITER_TO_LIST(iter)->kind)
+	{
+		iter.info = ITER_TO_LINK(iter)->prev;
+
+		return iter;
+	}
+
+	if (LIST_SKIP == ITER_TO_LIST(iter)->kind)
+	{
+		iter.info = PREV(ITER_TO_SNODE(iter), 0);
+
+		return iter;
+	}
+
+	iter.info = DLPrev(SliterToDiter(iter)).info;
+
+	return iter;
 }
 
 int SortedListIsSameIter(sliter_t iter1, sliter_t iter2)
@@ -224,9 +790,27 @@ int SortedListIsSameIter(sliter_t iter1, sliter_t iter2)
 
 void *SortedListGetData(sliter_t iter)
 {
+	if (LIST_LINKS == ITER_TO_LIST(iter)->kind)
+	{
+		return LINK_TO_DATA(ITER_TO_LIST(iter), iter.info);
+	}
+
+	if (LIST_SKIP == ITER_TO_LIST(iter)->kind)
+	{
+		return ITER_TO_SNODE(iter)->data;
+	}
+
 	return DLGetData(SliterToDiter(iter));
 }
 
+size_t SortedListGetKey(sliter_t iter)
+{
+	assert(LIST_SKIP == ITER_TO_LIST(iter)->kind);
+	assert(NULL == ITER_TO_LIST(iter)->is_before);
+
+	return ITER_TO_SNODE(iter)->key;
+}
+
 /*************************************************************
 			helper function
 **************************************************************/
@@ -239,24 +823,130 @@ static diter_t SliterToDiter(sliter_t sliter)
     assert(sliter.info);
 
     diter.info = sliter.info;
+    diter.list = ITER_TO_LIST(sliter)->list;
 
     return diter;
 }
 
-static sliter_t DiterToSliter(diter_t diter)
+static sliter_t DiterToSliter(const sortedlist_t *list, diter_t diter)
 {
     sliter_t sliter = {0};
 
     assert(diter.info);
 
     sliter.info = diter.info;
+    sliter.list = (sortedlist_t *)list;
+
+    return sliter;
+}
+
+static sliter_t MakeSliter(const sortedlist_t *list, void *info)
+{
+    sliter_t sliter = {0};
+
+    sliter.info = info;
+    sliter.list = (sortedlist_t *)list;
 
     return sliter;
 }
 
+static void SizeInc(sortedlist_t *list)
+{
+    ++list->size;
+    list->high_water = (list->size > list->high_water) ? list->size :
+                                                        list->high_water;
+}
+
+/*************************************************************
+			skip list helper functions
+**************************************************************/
+
+static snode_t *SkipNodeAlloc(size_t level)
+{
+	snode_t *node = (snode_t *)malloc(offsetof(snode_t, link)
+										+ 2 * level * sizeof(snode_t *));
+
+	if (NULL != node)
+	{
+		node->data = NULL;
+		node->level = level;
+	}
+
+	return node;
+}
 
+/* each level above the first is taken with probability 1/4 */
+static size_t SkipRandomLevel(sortedlist_t *list)
+{
+	unsigned long bits = 0;
+	size_t level = 1;
 
+	list->seed = list->seed * 6364136223846793005UL + 1442695040888963407UL;
+	bits = list->seed >> 32;
 
+	while (MAX_LEVEL > level && 0 == (bits & 3))
+	{
+		++level;
+		bits >>= 2;
+	}
 
+	return level;
+}
 
+/* after the elements equal to it, as the list variant does */
+static void SkipLink(sortedlist_t *list, snode_t *node)
+{
+	snode_t *pre = list->head;
+	size_t level = 0;
+
+	list->level = (node->level > list->level) ? node->level : list->level;
+
+	for (level = list->level; 0 < level; --level)
+	{
+		while (NEXT(pre, level - 1) != list->tail
+							&& !SkipIsBefore(list, node, NEXT(pre, level - 1)))
+		{
+			pre = NEXT(pre, level - 1);
+		}
 
+		if (level <= node->level)
+		{
+			NEXT(node, level - 1) = NEXT(pre, level - 1);
+			PREV(node, level - 1) = pre;
+			PREV(NEXT(pre, level - 1), level - 1) = node;
+			NEXT(pre, level - 1) = node;
+		}
+	}
+
+	SizeInc(list);
+}
+
+static void SkipUnlink(sortedlist_t *list, snode_t *node)
+{
+	size_t level = 0;
+
+	for (level = 0; level < node->level; ++level)
+	{
+		NEXT(PREV(node, level), level) = NEXT(node, level);
+		PREV(NEXT(node, level), level) = PREV(node, level);
+	}
+
+	while (1 < list->level && NEXT(list->head, list->level - 1) == list->tail)
+	{
+		--list->level;
+	}
+
+	--list->size;
+}
+
+/* a keyed list compares the keys in the nodes, without a call */
+static int SkipIsBefore(const sortedlist_t *list, const snode_t *node1,
+														const snode_t *node2)
+{
+	if (NULL == list->is_before)
+	{
+		return (node1->key < node2->key);
+	}
+
+	return list->is_before(node1->data, node2->data);
+}
@@ -8,22 +8,42 @@ Version 2.0
 #define SORTED_LL_H
 
 #include <stddef.h> /* size_t */
+#include "arena.h"  /* arena_t */
+#include "dllist.h" /* dlink_t */
 
 typedef struct sortedlist_s sortedlist_t;
 
 /*
 struct sortedlist_s
 {
+    list_kind_t kind;
     dlist_t *list;
     is_before_t is_before;
+    dlink_t links;
+    size_t offset;
+    snode_t *head;
+    snode_t *tail;
+    size_t level;
+    size_t size;
+    size_t high_water;
+    size_t allocs;
+    unsigned long seed;
 };
 */
 
 typedef struct
 {
   void *info;
+  void *list;
 } sliter_t;
 
+typedef struct
+{
+  size_t size;
+  size_t high_water;
+  size_t allocs;
+} sl_stats_t;
+
 typedef int (*s_operation_t)(void *data, void *arg);
 typedef int (*is_before_t)(const void *data, const void *to_compare);
 typedef int (*is_match_t)(const void *data, const void *to_cmp, void *arg);
@@ -40,6 +60,82 @@ typedef int (*is_match_t)(const void *data, const void *to_cmp, void *arg);
 */
 sortedlist_t *SortedListCreate(is_before_t before_func);
 
+/*
+  Creates a new sorted list with nodes taken from arena,
+  see DLCreateFromArena.
+
+  Arguments:
+    cmp_func - the operation perform in order to sort the list.
+    arena - must outlive the list.
+
+  Returns a pointer to the new list, NULL on failure.
+
+  Complexity O(1)
+*/
+sortedlist_t *SortedListCreateFromArena(is_before_t before_func,
+                                                        arena_t *arena);
+
+/*
+  Creates a new sorted list on an unrolled list, see DLCreateUnrolled.
+  All other SortedList functions work on it unchanged, except that
+  an Insert may invalidate iterators to elements near the new one.
+
+  Arguments:
+    cmp_func - the operation perform in order to sort the list.
+
+  Returns a pointer to the new list, NULL on failure.
+
+  Complexity O(1)
+*/
+sortedlist_t *SortedListCreateUnrolled(is_before_t before_func);
+
+/*
+  Creates a new sorted list backed by a skip list.
+  All other SortedList functions and iterators work on it unchanged.
+
+  Arguments:
+    cmp_func - the operation perform in order to sort the list.
+
+  Returns a pointer to the new list, NULL on failure.
+
+  Complexity O(1)
+  Insert and Search are O(log n) expected, Erase, Count, PopFront
+  and PopBack are O(1) for this list.
+*/
+sortedlist_t *SortedListCreateSkip(is_before_t before_func);
+
+/*
+  Creates a new skip list sorted by integer keys, ascending.
+  Elements go in with SortedListInsertKeyed and are found with
+  SortedListSearchKey, the key is kept in the node next to the
+  element, so ordering neither calls a function nor reads the
+  element. Other SortedList functions work on it unchanged,
+  it merges only with keyed lists.
+
+  Returns a pointer to the new list, NULL on failure.
+
+  Complexity O(1)
+*/
+sortedlist_t *SortedListCreateKeyed(void);
+
+/*
+  Creates a new sorted list of elements that embed a dlink_t,
+  see DLLinkInit. Insert links the element itself, so nothing
+  is allocated per element and Destroy leaves the elements alone.
+  All other SortedList functions and iterators work on it unchanged.
+
+  Arguments:
+    cmp_func - the operation perform in order to sort the list.
+    link_offset - offsetof the dlink_t in the element's struct,
+                  an element is in at most one list per link.
+
+  Returns a pointer to the new list, NULL on failure.
+
+  Complexity O(1)
+*/
+sortedlist_t *SortedListCreateIntrusive(is_before_t before_func,
+                                                    size_t link_offset);
+
 /*
   Destroy a given list, erase every member.
 
@@ -60,11 +156,24 @@ void SortedListDestroy(sortedlist_t *list);
 
     Returns the number of members in the list.
 
-    Complexity O(n)
+    Complexity O(1)
 */
 
 size_t SortedListCount(const sortedlist_t *list);
 
+/*
+  Fill stats for a given list: its size, the largest size it had,
+      and the number of nodes it allocated (0 for an intrusive list).
+
+  Argument:
+    list.
+    stats - filled by the function.
+
+  Complexity O(1)
+*/
+
+void SortedListStats(const sortedlist_t *list, sl_stats_t *stats);
+
 /*
   Check if a given list is empty
 
@@ -94,6 +203,23 @@ int SortedListIsEmpty(const sortedlist_t *list);
 
 sliter_t SortedListInsert(sortedlist_t *list, void *data);
 
+/*
+  Insert a new member to a keyed list, after the members with
+      an equal key.
+
+  Argument:
+    list - made by SortedListCreateKeyed.
+    data.
+    key.
+
+  Returns the iterator for the new member
+    on failure, returns End.
+
+  Complexity O(log n) expected
+*/
+
+sliter_t SortedListInsertKeyed(sortedlist_t *list, void *data, size_t key);
+
 /*
   Erase a given iterator.
 
@@ -165,6 +291,36 @@ sliter_t SortedListFind(
                         is_match_t is_match,
                         const void *to_find,  void *arg
                      );
+/*
+  Search a given list for an element equal to to_find,
+      one that neither is before the other.
+
+  Argument:
+      list.
+      to_find - compared with the list's before_func.
+
+  Returns iterator to the first equal member,
+    Returns End if there is none.
+
+  Complexity O(n), O(log n) for a skip list
+*/
+
+sliter_t SortedListSearch(sortedlist_t *list, const void *to_find);
+
+/*
+  Search a keyed list for the first member with key.
+
+  Argument:
+      list - made by SortedListCreateKeyed.
+      key.
+
+  Returns iterator to the member, End if there is none.
+
+  Complexity O(log n) expected
+*/
+
+sliter_t SortedListSearchKey(sortedlist_t *list, size_t key);
+
 /*
     Merge two given lists.
 
@@ -172,10 +328,20 @@ sliter_t SortedListFind(
        dest - where new list will start
        src - elements from this list will be added to dest
 
-    Complexity O(n)
+    Iterators to src's elements are invalid after the merge, also
+       when the element moved without a copy: take them again from
+       dest, an erase through an old one corrupts both counts.
+
+    Returns 0 on success. Returns 1 if an element could not be
+       allocated in dest, then the elements merged so far stay in
+       dest and the rest stay in src, both lists still sorted.
+
+    Complexity O(n). Lists of other kinds, or with nodes from other
+       pools (SortedListCreateFromArena), merge one element at a time,
+       O(n * m).
 */
 
-void SortedListMerge(sortedlist_t *dest, sortedlist_t *src);
+int SortedListMerge(sortedlist_t *dest, sortedlist_t *src);
 
 /******************************iter functions**********************************/
 
@@ -258,4 +424,15 @@ int SortedListIsSameIter(sliter_t iter1, sliter_t iter2);
 
 void *SortedListGetData(sliter_t iter);
 
+/*
+  Returns the key of a member of a keyed list.
+
+  Argument:
+      iter - not End.
+
+  Complexity O(1)
+*/
+
+size_t SortedListGetKey(sliter_t iter);
+
 #endif /* SORTED_LL_H */
@@ -0,0 +1,365 @@
+/*==============================================================================
+Data Structures - Hierarchical Timing Wheel
+Source
+OL66
+Version 1
+==============================================================================*/
+
+#include <stddef.h> /* size_t */
+#include <assert.h> /* assert */
+#include <stdlib.h> /* malloc */
+
+#include "timing_wheel.h"
+
+#define LEVELS (4)
+#define SLOT_BITS (8)
+#define SLOTS (1 << SLOT_BITS)
+#define SLOT_MASK ((size_t)SLOTS - 1)
+#define MAX_DELTA ((size_t)0xffffffffUL)
+#define LEVEL_SHIFT(level) (SLOT_BITS * (level))
+
+struct twheel_s
+{
+	twnode_t slots[LEVELS][SLOTS];
+	twnode_t ready;
+	size_t now;
+	size_t count;
+};
+
+static void InitHead(twnode_t *head);
+static int IsEmptyHead(const twnode_t *head);
+static void Link(twnode_t *head, twnode_t *node);
+static void Unlink(twnode_t *node);
+static void Place(twheel_t *wheel, twnode_t *node);
+static void Cascade(twheel_t *wheel, twnode_t *head);
+static void Tick(twheel_t *wheel);
+
+twheel_t *TWheelCreate(size_t now)
+{
+	twheel_t *wheel = (twheel_t *)malloc(sizeof(twheel_t));
+	size_t level = 0;
+	size_t slot = 0;
+
+	if (NULL == wheel)
+	{
+		return NULL;
+	}
+
+	for (level = 0; level < LEVELS; ++level)
+	{
+		for (slot = 0; slot < SLOTS; ++slot)
+		{
+			InitHead(&wheel->slots[level][slot]);
+		}
+	}
+
+	InitHead(&wheel->ready);
+	wheel->now = now;
+	wheel->count = 0;
+
+	return wheel;
+}
+
+void TWheelDestroy(twheel_t *wheel)
+{
+	assert(wheel);
+
+	free(wheel);
+	wheel = NULL;
+}
+
+void TWheelAdd(twheel_t *wheel, twnode_t *node, size_t expires)
+{
+	assert(wheel);
+	assert(node);
+
+	node->expires = expires;
+	Place(wheel, node);
+	++wheel->count;
+}
+
+void TWheelRemove(twheel_t *wheel, twnode_t *node)
+{
+	assert(wheel);
+	assert(node);
+
+	if (!TWheelIsArmed(node))
+	{
+		return;
+	}
+
+	Unlink(node);
+	--wheel->count;
+}
+
+int TWheelIsArmed(const twnode_t *node)
+{
+	assert(node);
+
+	return (NULL != node->next);
+}
+
+size_t TWheelSize(const twheel_t *wheel)
+{
+	assert(wheel);
+
+	return wheel->count;
+}
+
+twnode_t *TWheelExpire(twheel_t *wheel, size_t now)
+{
+	twnode_t *node = NULL;
+
+	assert(wheel);
+
+	if (0 == wheel->count)
+	{
+		/* nothing armed, no need to walk the skipped ticks */
+		if (wheel->now <= now)
+		{
+			wheel->now = now + 1;
+		}
+
+		return NULL;
+	}
+
+	/* jump straight to the next tick that has anything to do */
+	while (IsEmptyHead(&wheel->ready) && wheel->now <= now)
+	{
+		size_t next = TWheelNextExpiry(wheel);
+
+		if (next > now)
+		{
+			wheel->now = now + 1;
+			break;
+		}
+
+		if (next > wheel->now)
+		{
+			wheel->now = next;
+		}
+
+		Tick(wheel);
+	}
+
+	if (IsEmptyHead(&wheel->ready))
+	{
+		return NULL;
+	}
+
+	node = wheel->ready.next;
+	Unlink(node);
+	--wheel->count;
+
+	return node;
+}
+
+size_t TWheelNextExpiry(const twheel_t *wheel)
+{
+	size_t next = (size_t)-1;
+	size_t level = 0;
+	size_t offset = 0;
+
+	assert(wheel);
+	assert(0 < wheel->count);
+
+	if (!IsEmptyHead(&wheel->ready))
+	{
+		return wheel->now - (0 < wheel->now);
+	}
+
+	/* level 0 slots hold their exact expiry */
+	for (offset = 0; offset < SLOTS; ++offset)
+	{
+		size_t slot = (wheel->now + offset) & SLOT_MASK;
+
+		if (!IsEmptyHead(&wheel->slots[0][slot]))
+		{
+			next = wheel->now + offset;
+			break;
+		}
+	}
+
+	/* higher levels are bounded by the tick their slot cascades at,
+	   the current slot still cascades if now sits on its boundary */
+	for (level = 1; level < LEVELS; ++level)
+	{
+		size_t base = wheel->now >> LEVEL_SHIFT(level);
+		size_t low = wheel->now & (((size_t)1 << LEVEL_SHIFT(level)) - 1);
+		size_t first = (0 == low) ? 0 : 1;
+
+		if (next <= ((base + first) << LEVEL_SHIFT(level)))
+		{
+			break;
+		}
+
+		for (offset = first; offset < first + SLOTS; ++offset)
+		{
+			size_t slot = (base + offset) & SLOT_MASK;
+
+			if (!IsEmptyHead(&wheel->slots[level][slot]))
+			{
+				size_t cascade = (base + offset) << LEVEL_SHIFT(level);
+
+				if (cascade < next)
+				{
+					next = cascade;
+				}
+
+				break;
+			}
+		}
+	}
+
+	return next;
+}
+
+void TWheelClear(twheel_t *wheel, tw_clear_t clear_func, void *arg)
+{
+	size_t level = 0;
+	size_t slot = 0;
+
+	assert(wheel);
+	assert(clear_func);
+
+	while (!IsEmptyHead(&wheel->ready))
+	{
+		twnode_t *node = wheel->ready.next;
+
+		Unlink(node);
+		--wheel->count;
+		clear_func(node, arg);
+	}
+
+	for (level = 0; level < LEVELS; ++level)
+	{
+		for (slot = 0; slot < SLOTS; ++slot)
+		{
+			twnode_t *head = &wheel->slots[level][slot];
+
+			while (!IsEmptyHead(head))
+			{
+				twnode_t *node = head->next;
+
+				Unlink(node);
+				--wheel->count;
+				clear_func(node, arg);
+			}
+		}
+	}
+}
+
+/****************************************************************
+HELPER FUNCTION
+***************************************************************/
+static void InitHead(twnode_t *head)
+{
+	head->next = head;
+	head->prev = head;
+	head->expires = 0;
+}
+
+static int IsEmptyHead(const twnode_t *head)
+{
+	return (head->next == head);
+}
+
+static void Link(twnode_t *head, twnode_t *node)
+{
+	node->next = head;
+	node->prev = head->prev;
+	head->prev->next = node;
+	head->prev = node;
+}
+
+static void Unlink(twnode_t *node)
+{
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+	node->next = NULL;
+	node->prev = NULL;
+}
+
+/* slot choice by distance from now, far timers are clamped to the last
+   level and re-placed with their real expiry when they cascade */
+static void Place(twheel_t *wheel, twnode_t *node)
+{
+	size_t expires = node->expires;
+	size_t delta = 0;
+	size_t level = 0;
+
+	if (expires < wheel->now)
+	{
+		Link(&wheel->ready, node);
+
+		return;
+	}
+
+	delta = expires - wheel->now;
+
+	if (delta > MAX_DELTA)
+	{
+		delta = MAX_DELTA;
+		expires = wheel->now + MAX_DELTA;
+	}
+
+	while (level < LEVELS - 1 && delta >= ((size_t)1 << LEVEL_SHIFT(level + 1)))
+	{
+		++level;
+	}
+
+	Link(&wheel->slots[level][(expires >> LEVEL_SHIFT(level)) & SLOT_MASK],
+																		node);
+}
+
+static void Cascade(twheel_t *wheel, twnode_t *head)
+{
+	twnode_t list = {0};
+
+	if (IsEmptyHead(head))
+	{
+		return;
+	}
+
+	/* move the slot aside first, Place may link back into it */
+	list.next = head->next;
+	list.prev = head->prev;
+	list.next->prev = &list;
+	list.prev->next = &list;
+	InitHead(head);
+
+	while (!IsEmptyHead(&list))
+	{
+		twnode_t *node = list.next;
+
+		Unlink(node);
+		Place(wheel, node);
+	}
+}
+
+static void Tick(twheel_t *wheel)
+{
+	size_t index = wheel->now & SLOT_MASK;
+	size_t level = 1;
+	twnode_t *slot = NULL;
+
+	while (0 == index && level < LEVELS)
+	{
+		index = (wheel->now >> LEVEL_SHIFT(level)) & SLOT_MASK;
+		Cascade(wheel, &wheel->slots[level][index]);
+		++level;
+	}
+
+	slot = &wheel->slots[0][wheel->now & SLOT_MASK];
+
+	if (!IsEmptyHead(slot))
+	{
+		slot->next->prev = wheel->ready.prev;
+		wheel->ready.prev->next = slot->next;
+		slot->prev->next = &wheel->ready;
+		wheel->ready.prev = slot->prev;
+		InitHead(slot);
+	}
+
+	++wheel->now;
+}
@@ -0,0 +1,143 @@
+/*==============================================================================
+Data Structures - Hierarchical Timing Wheel
+Header
+OL66
+Version 1
+==============================================================================*/
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <stddef.h> /* size_t */
+
+typedef struct twnode_s twnode_t;
+
+/*
+                        WARNING!!!
+struct definition is for use of implementor,
+any changes to it will result in undefined behaviour.
+The node is embedded by the user in the timer it represents.
+*/
+struct twnode_s
+{
+	twnode_t *next;
+	twnode_t *prev;
+	size_t expires;
+};
+
+typedef struct twheel_s twheel_t;
+/*
+struct twheel_s
+{
+	twnode_t slots[LEVELS][SLOTS];
+	twnode_t ready;
+	size_t now;
+	size_t count;
+};
+*/
+
+typedef void (*tw_clear_t)(twnode_t *node, void *arg);
+
+/*
+	Creates a new timing wheel.
+
+	Arguments:
+		now - the current tick.
+
+	returns wheel pointer, NULL on failure.
+
+	complexity O(1)
+*/
+twheel_t *TWheelCreate(size_t now);
+
+/*
+	Destroy a given wheel.
+	Nodes still armed are not touched.
+
+	arguments:
+		wheel.
+
+	complexity O(1)
+*/
+void TWheelDestroy(twheel_t *wheel);
+
+/*
+	Arm a node to expire at a given tick.
+	A tick that already passed expires on the next TWheelExpire.
+
+	arguments:
+		wheel.
+		node - unarmed node.
+		expires - tick to expire at.
+
+	complexity O(1)
+*/
+void TWheelAdd(twheel_t *wheel, twnode_t *node, size_t expires);
+
+/*
+	Disarm a given node.
+	Removing a node that is not armed does nothing.
+
+	arguments:
+		wheel.
+		node.
+
+	complexity O(1)
+*/
+void TWheelRemove(twheel_t *wheel, twnode_t *node);
+
+/*
+	returns true if the node is armed, false otherwise.
+
+	complexity O(1)
+*/
+int TWheelIsArmed(const twnode_t *node);
+
+/*
+	Count armed nodes.
+
+	arguments:
+		wheel.
+
+	complexity O(1)
+*/
+size_t TWheelSize(const twheel_t *wheel);
+
+/*
+	Advance the wheel up to a given tick and disarm one expired node.
+	Nodes that expire on the same tick come out in no particular order.
+
+	arguments:
+		wheel.
+		now - the current tick.
+
+	returns an expired node, NULL if none expired yet.
+
+	complexity O(1) per tick advanced
+*/
+twnode_t *TWheelExpire(twheel_t *wheel, size_t now);
+
+/*
+	Earliest tick at which TWheelExpire may return a node.
+	Never later than the real earliest expiry, may be earlier
+	when far timers still need to cascade down.
+
+	arguments:
+		wheel - a non empty wheel.
+
+	complexity O(1)
+*/
+size_t TWheelNextExpiry(const twheel_t *wheel);
+
+/*
+	Disarm every node, calling clear_func on each.
+
+	arguments:
+		wheel.
+		clear_func - called once per node after it was disarmed.
+		arg - argument for clear_func.
+
+	complexity O(n)
+*/
+void TWheelClear(twheel_t *wheel, tw_clear_t clear_func, void *arg);
+
+#endif /* TIMING_WHEEL_H */
@@ -0,0 +1,232 @@
+/*==============================================================================
+Data Structures - UID Hash Table
+Source
+OL66
+Version 1
+==============================================================================*/
+
+#include <stddef.h> /* size_t */
+#include <assert.h> /* assert */
+#include <stdlib.h> /* malloc */
+
+#include "uid_table.h"
+
+#define MIN_CAPACITY (16)
+#define HASH_MULT ((size_t)0x9E3779B97F4A7C15UL)
+
+typedef struct
+{
+	ilrd_uid_t uid;
+	void *data;
+} entry_t;
+
+struct uid_table_s
+{
+	entry_t *entries;
+	size_t capacity;
+	size_t size;
+};
+
+static size_t Hash(ilrd_uid_t uid);
+static size_t FindSlot(const uid_table_t *table, ilrd_uid_t uid);
+static int Grow(uid_table_t *table);
+static entry_t *AllocEntries(size_t capacity);
+
+uid_table_t *UIDTableCreate(size_t capacity)
+{
+	uid_table_t *table = (uid_table_t *)malloc(sizeof(uid_table_t));
+	size_t real_capacity = MIN_CAPACITY;
+
+	if (NULL == table)
+	{
+		return NULL;
+	}
+
+	/* keep load below one half */
+	while (real_capacity < 2 * capacity)
+	{
+		real_capacity *= 2;
+	}
+
+	table->entries = AllocEntries(real_capacity);
+
+	if (NULL == table->entries)
+	{
+		free(table);
+
+		return NULL;
+	}
+
+	table->capacity = real_capacity;
+	table->size = 0;
+
+	return table;
+}
+
+void UIDTableDestroy(uid_table_t *table)
+{
+	assert(table);
+
+	free(table->entries);
+	free(table);
+	table = NULL;
+}
+
+int UIDTableInsert(uid_table_t *table, ilrd_uid_t uid, void *data)
+{
+	size_t slot = 0;
+
+	assert(table);
+	assert(data);
+
+	if (2 * (table->size + 1) > table->capacity && 0 != Grow(table))
+	{
+		return 1;
+	}
+
+	slot = FindSlot(table, uid);
+
+	assert(NULL == table->entries[slot].data);
+
+	table->entries[slot].uid = uid;
+	table->entries[slot].data = data;
+	++table->size;
+
+	return 0;
+}
+
+void *UIDTableFind(const uid_table_t *table, ilrd_uid_t uid)
+{
+	assert(table);
+
+	return table->entries[FindSlot(table, uid)].data;
+}
+
+void *UIDTableRemove(uid_table_t *table, ilrd_uid_t uid)
+{
+	size_t mask = 0;
+	size_t hole = 0;
+	size_t next = 0;
+	void *data = NULL;
+
+	assert(table);
+
+	mask = table->capacity - 1;
+	hole = FindSlot(table, uid);
+	data = table->entries[hole].data;
+
+	if (NULL == data)
+	{
+		return NULL;
+	}
+
+	/* backward shift, keeps probe chains intact without tombstones */
+	for (next = (hole + 1) & mask; NULL != table->entries[next].data;
+														next = (next + 1) & mask)
+	{
+		size_t home = Hash(table->entries[next].uid) & mask;
+
+		if (((next - home) & mask) >= ((next - hole) & mask))
+		{
+			table->entries[hole] = table->entries[next];
+			hole = next;
+		}
+	}
+
+	table->entries[hole].data = NULL;
+	--table->size;
+
+	return data;
+}
+
+size_t UIDTableSize(const uid_table_t *table)
+{
+	assert(table);
+
+	return table->size;
+}
+
+int UIDTableForEach(const uid_table_t *table, int (*op)(void *data, void *arg),
+																void *arg)
+{
+	size_t i = 0;
+	int status = 0;
+
+	assert(table);
+	assert(op);
+
+	for (i = 0; i < table->capacity && 0 == status; ++i)
+	{
+		if (NULL != table->entries[i].data)
+		{
+			status = op(table->entries[i].data, arg);
+		}
+	}
+
+	return status;
+}
+
+/*************************************************************
+			helper function
+**************************************************************/
+
+static size_t Hash(ilrd_uid_t uid)
+{
+	size_t hash = uid.counter;
+
+	hash = (hash ^ (size_t)uid.pid) * HASH_MULT;
+	hash = (hash ^ (size_t)uid.time.tv_usec) * HASH_MULT;
+	hash = (hash ^ (size_t)uid.time.tv_sec) * HASH_MULT;
+
+	return hash ^ (hash >> 29);
+}
+
+/* slot holding uid, or the empty slot it would go to */
+static size_t FindSlot(const uid_table_t *table, ilrd_uid_t uid)
+{
+	size_t mask = table->capacity - 1;
+	size_t slot = Hash(uid) & mask;
+
+	while (NULL != table->entries[slot].data &&
+								!UIDIsSame(table->entries[slot].uid, uid))
+	{
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+static int Grow(uid_table_t *table)
+{
+	entry_t *old_entries = table->entries;
+	size_t old_capacity = table->capacity;
+	size_t i = 0;
+
+	table->entries = AllocEntries(2 * old_capacity);
+
+	if (NULL == table->entries)
+	{
+		table->entries = old_entries;
+
+		return 1;
+	}
+
+	table->capacity = 2 * old_capacity;
+
+	for (i = 0; i < old_capacity; ++i)
+	{
+		if (NULL != old_entries[i].data)
+		{
+			table->entries[FindSlot(table, old_entries[i].uid)] = old_entries[i];
+		}
+	}
+
+	free(old_entries);
+
+	return 0;
+}
+
+static entry_t *AllocEntries(size_t capacity)
+{
+	return (entry_t *)calloc(capacity, sizeof(entry_t));
+}
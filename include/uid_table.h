@@ -0,0 +1,96 @@
+/*==============================================================================
+Data Structures - UID Hash Table
+Header
+OL66
+Version 1
+==============================================================================*/
+#ifndef UID_TABLE_H
+#define UID_TABLE_H
+
+#include <stddef.h>        /* size_t */
+#include "ilrd_uid.h"      /* ilrd_uid_t */
+
+typedef struct uid_table_s uid_table_t;
+/*
+struct uid_table_s
+{
+	entry_t *entries;
+	size_t capacity;
+	size_t size;
+};
+*/
+
+/*
+	Creates a new table mapping unique identifiers to data.
+	Open addressing, grows as needed.
+
+	Arguments:
+		capacity - expected number of entries, may be 0.
+
+	returns table pointer, NULL on failure.
+
+	complexity O(capacity)
+*/
+uid_table_t *UIDTableCreate(size_t capacity);
+
+/*
+	Destroy a given table, data is not touched.
+
+	complexity O(1)
+*/
+void UIDTableDestroy(uid_table_t *table);
+
+/*
+	Map uid to data. uid must not be bad or already in the table.
+
+	Arguments:
+		table.
+		uid.
+		data - non NULL.
+
+	returns 0 on success, non zero on allocation failure.
+
+	complexity O(1) amortized
+*/
+int UIDTableInsert(uid_table_t *table, ilrd_uid_t uid, void *data);
+
+/*
+	returns the data mapped to uid, NULL if not found.
+
+	complexity O(1) average
+*/
+void *UIDTableFind(const uid_table_t *table, ilrd_uid_t uid);
+
+/*
+	Remove uid from the table.
+
+	returns the data it was mapped to, NULL if not found.
+
+	complexity O(1) average
+*/
+void *UIDTableRemove(uid_table_t *table, ilrd_uid_t uid);
+
+/*
+	returns number of entries.
+
+	complexity O(1)
+*/
+size_t UIDTableSize(const uid_table_t *table);
+
+/*
+	Call op on the data of every entry, in no particular order.
+	op must not insert or remove entries.
+
+	Arguments:
+		table.
+		op - returns 0 to go on, !0 to stop.
+		arg - passed to op.
+
+	returns 0 if op was called on every entry, what op returned otherwise.
+
+	complexity O(capacity)
+*/
+int UIDTableForEach(const uid_table_t *table, int (*op)(void *data, void *arg),
+																void *arg);
+
+#endif /* UID_TABLE_H */
@@ -1,6 +1,37 @@
 #ifndef _WATCH_DOG
 #define _WATCH_DOG
 
+/*        scheduling of the heartbeat thread and the WD process
+                WD_SCHED_DEFAULT - the normal time shared policy
+                WD_SCHED_FIFO - real time, runs until it sleeps
+                WD_SCHED_RR - real time, round robin among equal priorities
+*/
+typedef enum
+{
+        WD_SCHED_DEFAULT,
+        WD_SCHED_FIFO,
+        WD_SCHED_RR
+} wd_sched_t;
+
+/*        options for WDKeepAliveOpt, initialize with WDOptionsInit
+                policy - scheduling policy, WD_SCHED_DEFAULT by default
+                priority - 1 to 99 for the real time policies
+                cpu - CPU to pin to, -1 (the default) for any
+                lock_memory - !0 to mlockall, so a heartbeat never
+                                waits for a page to be read back in
+
+        Without the privileges (CAP_SYS_NICE, RLIMIT_RTPRIO,
+        RLIMIT_MEMLOCK) an option falls back to the default and the
+        rest still apply.
+*/
+typedef struct wd_options_s
+{
+        wd_sched_t policy;
+        int priority;
+        int cpu;
+        int lock_memory;
+} wd_options_t;
+
 /*        Creates a Watchdog process to keep calling process alive.
         arguments:
                 num_args - number of strings in args_vector.
@@ -16,6 +47,39 @@ int WDKeepAlive(const char *abs_app_path,
                                 int num_args,
                                 char const *args_vector[]);
 
+/*        Set options to the defaults WDKeepAlive uses.
+        arguments:
+                options - options to initialize
+*/
+void WDOptionsInit(wd_options_t *options);
+
+/*        Same as WDKeepAlive, with options for the heartbeat scheduler
+        thread of the calling process and for the WD process.
+        The WD process gets them through its environment, and keeps
+        them across restarts.
+        arguments:
+                options - NULL for the defaults
+
+        returns:
+                on success - 0
+                on failure - != 0
+*/
+int WDKeepAliveOpt(const char *abs_app_path,
+                                int num_args,
+                                char const *args_vector[],
+                                const wd_options_t *options);
+
+/*        Apply options to the calling thread, as WDKeepAliveOpt does to
+        its heartbeat thread. lock_memory applies to the whole process.
+        arguments:
+                options - options to apply
+
+        returns:
+                all applied - 0
+                some fell back to the default - != 0
+*/
+int WDApplyOptions(const wd_options_t *options);
+
 /*        Frees all resources allocated by WDKeepAlive
         arguments:
                 resources - pointer to resources, WDKeepAlive
@@ -1,3 +1,4 @@
+#define _GNU_SOURCE
 #define _POSIX_C_SOURCE (0xfffffffff)
 
 #include <pthread.h>        /*thread            */
@@ -7,6 +8,10 @@
 #include <string.h>         /*strcmp            */
 #include <semaphore.h>      /*semaphore         */
 #include <fcntl.h>          /*named semaphore   */
+#include <sched.h>          /*cpu affinity      */
+#include <unistd.h>         /*geteuid           */
+#include <sys/mman.h>       /*mlockall          */
+#include <sys/resource.h>   /*getrlimit         */
 
 #define RESET   	"\033[0m"       
 #define BOLDBLUE	"\033[01;34m"      
@@ -24,6 +29,10 @@
 #define UNUSED(x) ((void)x)
 #define UP_WD ("./wd.out")
 #define RETRY (4)
+#define HEARTBEAT_MS (1000)
+#define HEARTBEAT_SLACK_MS (50)
+#define OPTIONS_ENV ("WD_OPTIONS")
+#define DEFAULT_PRIORITY (10)
 
 static sch_t *g_sch = NULL;
 static pid_t g_who_to_kill = {0};
@@ -34,6 +43,7 @@ static size_t g_counter = 0;
 static int g_who_am_i = APP;
 static char *g_wd_arg[2] = {0};  
 static volatile int g_application_running = 1;
+static wd_options_t g_options = {WD_SCHED_DEFAULT, DEFAULT_PRIORITY, -1, 0};
 
 /*handlers*/
 static int InitResuorces(void);
@@ -45,18 +55,33 @@ static void USR2Handler(int sig);
 /*schduler*/
 static int SendUSR1(void *arg);
 static int CheckCounter(void *arg);
+/*options*/
+static void OptionsToEnv(const wd_options_t *options);
+static void OptionsFromEnv(wd_options_t *options);
+static int LockMemory(void);
 /*tasks*/
 static void InitScheduler(void);
 static void WDTask(void);
 static int APPTask(pid_t pid);
 
 int WDKeepAlive(const char *abs_app_path, int argc,char const *argv[])
+{
+    return WDKeepAliveOpt(abs_app_path, argc, argv, NULL);
+}
+
+int WDKeepAliveOpt(const char *abs_app_path, int argc, char const *argv[],
+                                                const wd_options_t *options)
 {
     pid_t wd_process = {0};
     
     UNUSED(abs_app_path);
     UNUSED(argc);
 
+    if (NULL != options)
+    {
+        g_options = *options;
+    }
+
     if (SUCCESS != InitResuorces())
     {
         return FAILURE;
@@ -65,6 +90,7 @@ int WDKeepAlive(const char *abs_app_path, int argc,char const *argv[])
     if (0 == strcmp(argv[0], UP_WD))
     {   
         g_who_am_i = WD;
+        OptionsFromEnv(&g_options);
         g_wd_arg[0] = (char *)argv[1];
         
         WDTask();
@@ -72,6 +98,8 @@ int WDKeepAlive(const char *abs_app_path, int argc,char const *argv[])
 
     else
     {
+        /* the WD process and every restart of it read them back */
+        OptionsToEnv(&g_options);
         wd_process = fork();
         g_wd_arg[1] = (char *)argv[0];
         g_wd_arg[0] = UP_WD;
@@ -96,6 +124,7 @@ static void WDTask(void)
     
     printf(BOLDBLUE"i am wd: %u\n",getpid());
     
+    WDApplyOptions(&g_options);
     InitScheduler();
     SchRun(g_sch);
 
@@ -108,6 +137,7 @@ static void *APPThread(void *arg)
     
     sem_wait(g_shared_sem);
     
+    WDApplyOptions(&g_options);
     InitScheduler();
     SchRun(g_sch);
     
@@ -138,6 +168,56 @@ static int APPTask(pid_t pid)
     return SUCCESS;
 }
 
+void WDOptionsInit(wd_options_t *options)
+{
+    options->policy = WD_SCHED_DEFAULT;
+    options->priority = DEFAULT_PRIORITY;
+    options->cpu = -1;
+    options->lock_memory = 0;
+}
+
+int WDApplyOptions(const wd_options_t *options)
+{
+    int status = SUCCESS;
+
+    if (0 <= options->cpu)
+    {
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(options->cpu, &set);
+
+        if (0 != pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+        {
+            printf("can't pin to cpu %d, running on any\n", options->cpu);
+            status = FAILURE;
+        }
+    }
+
+    if (WD_SCHED_DEFAULT != options->policy)
+    {
+        struct sched_param param = {0};
+        int policy = (WD_SCHED_FIFO == options->policy) ? SCHED_FIFO :
+                                                                SCHED_RR;
+
+        param.sched_priority = options->priority;
+
+        /* without privileges the thread keeps the default policy */
+        if (0 != pthread_setschedparam(pthread_self(), policy, &param))
+        {
+            printf("no real time priority, running time shared\n");
+            status = FAILURE;
+        }
+    }
+
+    if (options->lock_memory && SUCCESS != LockMemory())
+    {
+        status = FAILURE;
+    }
+
+    return status;
+}
+
 void WDFree(void)
 {
     size_t i = 0;
@@ -282,10 +362,66 @@ static int CheckCounter(void *arg)
     return 0;
 }
 
+static void OptionsToEnv(const wd_options_t *options)
+{
+    char buffer[64] = {0};
+
+    sprintf(buffer, "%d %d %d %d", (int)options->policy, options->priority,
+                                    options->cpu, options->lock_memory);
+    setenv(OPTIONS_ENV, buffer, 1);
+}
+
+/* a missing or broken variable leaves the options as they are */
+static void OptionsFromEnv(wd_options_t *options)
+{
+    const char *buffer = getenv(OPTIONS_ENV);
+    int policy = 0;
+    wd_options_t parsed = {0};
+
+    if (NULL == buffer || 4 != sscanf(buffer, "%d %d %d %d", &policy,
+                    &parsed.priority, &parsed.cpu, &parsed.lock_memory) ||
+                    0 > policy || WD_SCHED_RR < policy)
+    {
+        return;
+    }
+
+    parsed.policy = (wd_sched_t)policy;
+    *options = parsed;
+}
+
+/* under a memlock limit MCL_FUTURE would make later allocations fail,
+   only what is mapped now is locked then */
+static int LockMemory(void)
+{
+    struct rlimit limit = {0};
+    int flags = MCL_CURRENT;
+
+    if (0 == geteuid() || (0 == getrlimit(RLIMIT_MEMLOCK, &limit) &&
+                                            RLIM_INFINITY == limit.rlim_cur))
+    {
+        flags |= MCL_FUTURE;
+    }
+
+    if (0 != mlockall(flags))
+    {
+        printf("can't lock memory, pages may be swapped out\n");
+
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+/* both tasks may wait a little, to share one wakeup */
 static void InitScheduler(void)
 {
-    SchAdd(g_sch, 1, SendUSR1, NULL);
-    SchAdd(g_sch, 1, CheckCounter, NULL);
+    sch_attr_t attr;
+
+    SchAttrInit(&attr, HEARTBEAT_MS);
+    attr.slack = HEARTBEAT_SLACK_MS;
+
+    SchAddAttr(g_sch, &attr, SendUSR1, NULL);
+    SchAddAttr(g_sch, &attr, CheckCounter, NULL);
 }
 
 static void DestroyAll(void)